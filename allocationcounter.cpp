@@ -0,0 +1,68 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "allocationcounter.h"
+
+#ifdef BLACKBOX_COUNT_ALLOCATIONS
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+thread_local std::uint64_t allocations = 0;
+}
+
+void* operator new(std::size_t size) {
+	++allocations;
+	void* memory = std::malloc(size ? size : 1);
+	if (!memory) {
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void* operator new[](std::size_t size) {
+	return operator new(size);
+}
+
+void operator delete(void* memory) noexcept {
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+	std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+	std::free(memory);
+}
+
+std::uint64_t allocationCount() {
+	return allocations;
+}
+
+#else
+
+std::uint64_t allocationCount() {
+	return 0;
+}
+
+#endif
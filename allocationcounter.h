@@ -0,0 +1,27 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BLACKBOX_ALLOCATIONCOUNTER_H
+#define BLACKBOX_ALLOCATIONCOUNTER_H
+
+#include <cstdint>
+
+// number of calls to the global operator new so far on the calling thread (the game thread does not count for the frames)
+// only counted when built with BLACKBOX_COUNT_ALLOCATIONS (cmake -DBLACKBOX_COUNT_ALLOCATIONS=ON), otherwise 0
+std::uint64_t allocationCount();
+
+#endif
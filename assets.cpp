@@ -0,0 +1,60 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "assets.h"
+
+using namespace irr;
+
+scene::SMesh* createBakedMesh(const BakedMesh& baked) {
+	scene::SMeshBuffer* buffer = new scene::SMeshBuffer();
+	video::SMaterial& material = buffer->Material;
+	material.AmbientColor = video::SColor(baked.ambient);
+	material.DiffuseColor = video::SColor(baked.diffuse);
+	material.SpecularColor = video::SColor(baked.specular);
+	material.Shininess = baked.shininess;
+
+	buffer->Vertices.reallocate(baked.vertexCount);
+	for (unsigned int i = 0; i < baked.vertexCount; ++i) {
+		const BakedVertex& vertex = baked.vertices[i];
+		buffer->Vertices.push_back(video::S3DVertex(core::vector3df(vertex.pos[0], vertex.pos[1], vertex.pos[2]),
+			core::vector3df(vertex.normal[0], vertex.normal[1], vertex.normal[2]),
+			material.DiffuseColor, core::vector2df(vertex.uv[0], vertex.uv[1])));
+	}
+	buffer->Indices.reallocate(baked.indexCount);
+	for (unsigned int i = 0; i < baked.indexCount; ++i) {
+		buffer->Indices.push_back(baked.indices[i]);
+	}
+	buffer->recalculateBoundingBox();
+
+	scene::SMesh* mesh = new scene::SMesh();
+	mesh->addMeshBuffer(buffer);
+	buffer->drop();
+	mesh->recalculateBoundingBox();
+	return mesh;
+}
+
+video::ITexture* getBakedTexture(IrrlichtDevice* device, const BakedFile& baked, const io::path& name) {
+	video::IVideoDriver* driver = device->getVideoDriver();
+	// the memory file only reads the baked bytes, it never writes or frees them
+	io::IReadFile* file = device->getFileSystem()->createMemoryReadFile(const_cast<unsigned char*>(baked.data), baked.size, name, false);
+	if (!file) {
+		return 0;
+	}
+	video::ITexture* texture = driver->getTexture(file);
+	file->drop();
+	return texture;
+}
@@ -0,0 +1,30 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BLACKBOX_ASSETS_H
+#define BLACKBOX_ASSETS_H
+
+#include <irrlicht.h>
+#include "bakedassets.h"
+
+// a mesh built from a baked one, the same as the obj loader would have returned (drop it when done)
+irr::scene::SMesh* createBakedMesh(const BakedMesh& baked);
+
+// loads a baked image through the video driver (cached by the driver under the given name)
+irr::video::ITexture* getBakedTexture(irr::IrrlichtDevice* device, const BakedFile& baked, const irr::io::path& name);
+
+#endif
@@ -0,0 +1,266 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// turns the obj models and images into a source file with constant arrays (see bakedassets.h), so
+// the game starts without parsing text and without looking for files relative to the working directory
+
+namespace {
+
+struct Vec {
+	float v[3];
+};
+
+struct Material {
+	float ambient[4] = {0.2f, 0.2f, 0.2f, 1.0f};
+	float diffuse[4] = {0.8f, 0.8f, 0.8f, 1.0f};
+	float specular[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+	float shininess = 0.0f;
+};
+
+struct Mesh {
+	std::vector<float> vertices;	// pos, normal and uv of each vertex
+	std::vector<unsigned int> indices;
+	Material material;
+};
+
+void usage() {
+	std::cerr << "usage: blackbox-bake output.cpp [mesh name file.obj | file name file]..." << std::endl;
+}
+
+unsigned int argb(const float color[4]) {
+	unsigned int value = 0;
+	const int order[] = {3, 0, 1, 2};
+	for (int i : order) {
+		float c = color[i] < 0 ? 0 : (color[i] > 1 ? 1 : color[i]);
+		value = (value << 8) | static_cast<unsigned int>(c*255.0f);
+	}
+	return value;
+}
+
+bool readMaterials(const std::string& fileName, std::map<std::string, Material>& materials) {
+	std::ifstream file(fileName);
+	if (!file) {
+		std::cerr << "cannot open " << fileName << std::endl;
+		return false;
+	}
+	std::string line;
+	Material* current = 0;
+	while (std::getline(file, line)) {
+		std::istringstream words(line);
+		std::string key;
+		words >> key;
+		if (key == "newmtl") {
+			std::string name;
+			words >> name;
+			current = &materials[name];
+		} else if (!current) {
+			continue;
+		} else if (key == "Ka") {
+			words >> current->ambient[0] >> current->ambient[1] >> current->ambient[2];
+		} else if (key == "Kd") {
+			words >> current->diffuse[0] >> current->diffuse[1] >> current->diffuse[2];
+		} else if (key == "Ks") {
+			words >> current->specular[0] >> current->specular[1] >> current->specular[2];
+		} else if (key == "Ns") {
+			words >> current->shininess;
+		} else if (key == "d") {
+			float alpha;
+			words >> alpha;
+			current->ambient[3] = current->diffuse[3] = current->specular[3] = alpha;
+		}
+	}
+	return true;
+}
+
+// resolves a (1 based or negative) obj index
+int objIndex(const std::string& text, std::size_t count) {
+	int index = std::atoi(text.c_str());
+	return index < 0 ? static_cast<int>(count) + index : index - 1;
+}
+
+bool readMesh(const std::string& fileName, Mesh& mesh) {
+	std::ifstream file(fileName);
+	if (!file) {
+		std::cerr << "cannot open " << fileName << std::endl;
+		return false;
+	}
+	std::string directory = fileName.substr(0, fileName.find_last_of('/')+1);
+	std::map<std::string, Material> materials;
+	std::string material;
+	std::vector<Vec> positions, normals, uvs;
+	std::map<std::tuple<int, int, int>, unsigned int> corners;
+	std::string line;
+	while (std::getline(file, line)) {
+		std::istringstream words(line);
+		std::string key;
+		words >> key;
+		if (key == "v" || key == "vn" || key == "vt") {
+			Vec vec = {{0, 0, 0}};
+			words >> vec.v[0] >> vec.v[1] >> vec.v[2];
+			if (key == "vt") {
+				vec.v[1] = 1 - vec.v[1];
+				uvs.push_back(vec);
+			} else {
+				// irrlicht is left handed
+				vec.v[0] = -vec.v[0];
+				(key == "v" ? positions : normals).push_back(vec);
+			}
+		} else if (key == "mtllib") {
+			std::string name;
+			words >> name;
+			if (!readMaterials(directory + name, materials)) {
+				return false;
+			}
+		} else if (key == "usemtl") {
+			std::string name;
+			words >> name;
+			if (!material.empty() && name != material) {
+				std::cerr << fileName << ": only a single material is supported" << std::endl;
+				return false;
+			}
+			material = name;
+		} else if (key == "f") {
+			std::vector<unsigned int> face;
+			std::string corner;
+			while (words >> corner) {
+				// v, v/vt, v//vn or v/vt/vn
+				std::string parts[3];
+				std::istringstream split(corner);
+				for (int i = 0; i < 3 && std::getline(split, parts[i], '/'); ++i) {
+				}
+				int v = objIndex(parts[0], positions.size());
+				int vt = parts[1].empty() ? -1 : objIndex(parts[1], uvs.size());
+				int vn = parts[2].empty() ? -1 : objIndex(parts[2], normals.size());
+				if (v < 0 || v >= static_cast<int>(positions.size()) || vt >= static_cast<int>(uvs.size()) || vn >= static_cast<int>(normals.size())) {
+					std::cerr << fileName << ": invalid face " << line << std::endl;
+					return false;
+				}
+				auto key = std::make_tuple(v, vt, vn);
+				auto found = corners.find(key);
+				if (found == corners.end()) {
+					found = corners.insert(std::make_pair(key, static_cast<unsigned int>(mesh.vertices.size()/8))).first;
+					Vec normal = vn < 0 ? Vec{{0, 0, 0}} : normals[vn];
+					Vec uv = vt < 0 ? Vec{{0, 0, 0}} : uvs[vt];
+					mesh.vertices.insert(mesh.vertices.end(), positions[v].v, positions[v].v+3);
+					mesh.vertices.insert(mesh.vertices.end(), normal.v, normal.v+3);
+					mesh.vertices.insert(mesh.vertices.end(), uv.v, uv.v+2);
+				}
+				face.push_back(found->second);
+			}
+			// a fan with the winding reversed, the same as the obj loader
+			for (std::size_t i = 1; i+1 < face.size(); ++i) {
+				mesh.indices.push_back(face[i+1]);
+				mesh.indices.push_back(face[i]);
+				mesh.indices.push_back(face[0]);
+			}
+		}
+	}
+	if (mesh.vertices.size()/8 > 65536) {
+		std::cerr << fileName << ": too many vertices" << std::endl;
+		return false;
+	}
+	if (!material.empty()) {
+		mesh.material = materials[material];
+	}
+	return true;
+}
+
+void writeMesh(std::FILE* out, const std::string& name, const Mesh& mesh) {
+	std::fprintf(out, "const BakedVertex %sVertices[] = {\n", name.c_str());
+	for (std::size_t i = 0; i < mesh.vertices.size(); i += 8) {
+		const float* v = &mesh.vertices[i];
+		std::fprintf(out, "\t{{%.9g, %.9g, %.9g}, {%.9g, %.9g, %.9g}, {%.9g, %.9g}},\n", v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7]);
+	}
+	std::fprintf(out, "};\n\nconst unsigned short %sIndices[] = {", name.c_str());
+	for (std::size_t i = 0; i < mesh.indices.size(); ++i) {
+		std::fprintf(out, "%s%u,", i % 24 ? " " : "\n\t", mesh.indices[i]);
+	}
+	std::fprintf(out, "\n};\n\n");
+}
+
+bool writeFile(std::FILE* out, const std::string& name, const std::string& fileName, std::size_t& size) {
+	std::ifstream file(fileName, std::ios::binary);
+	if (!file) {
+		std::cerr << "cannot open " << fileName << std::endl;
+		return false;
+	}
+	std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	size = bytes.size();
+	std::fprintf(out, "const unsigned char %sData[] = {", name.c_str());
+	for (std::size_t i = 0; i < bytes.size(); ++i) {
+		std::fprintf(out, "%s0x%02x,", i % 16 ? " " : "\n\t", static_cast<unsigned char>(bytes[i]));
+	}
+	std::fprintf(out, "\n};\n\n");
+	return true;
+}
+
+}
+
+int main(int argc, char** argv) {
+	if (argc < 2 || (argc-2) % 3 != 0) {
+		usage();
+		return 1;
+	}
+	std::FILE* out = std::fopen(argv[1], "w");
+	if (!out) {
+		std::cerr << "cannot write " << argv[1] << std::endl;
+		return 1;
+	}
+	std::fprintf(out, "// generated by blackbox-bake, do not edit\n\n#include \"bakedassets.h\"\n\nnamespace {\n\n");
+	// the definitions with external linkage follow the arrays outside of the namespace
+	std::ostringstream definitions;
+	for (int i = 2; i+2 < argc; i += 3) {
+		std::string kind = argv[i];
+		std::string name = argv[i+1];
+		if (kind == "mesh") {
+			Mesh mesh;
+			if (!readMesh(argv[i+2], mesh)) {
+				std::fclose(out);
+				return 1;
+			}
+			writeMesh(out, name, mesh);
+			char shininess[32];
+			std::snprintf(shininess, sizeof(shininess), "%.9g", mesh.material.shininess);
+			definitions << "extern const BakedMesh " << name << " = {" << name << "Vertices, " << mesh.vertices.size()/8 << ", "
+				<< name << "Indices, " << mesh.indices.size() << ", " << argb(mesh.material.ambient) << "u, "
+				<< argb(mesh.material.diffuse) << "u, " << argb(mesh.material.specular) << "u, " << shininess << "};\n";
+		} else if (kind == "file") {
+			std::size_t size;
+			if (!writeFile(out, name, argv[i+2], size)) {
+				std::fclose(out);
+				return 1;
+			}
+			definitions << "extern const BakedFile " << name << " = {" << name << "Data, " << size << "};\n";
+		} else {
+			usage();
+			std::fclose(out);
+			return 1;
+		}
+	}
+	std::fprintf(out, "}\n\n%s", definitions.str().c_str());
+	return std::fclose(out) == 0 ? 0 : 1;
+}
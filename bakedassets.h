@@ -0,0 +1,53 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BLACKBOX_BAKEDASSETS_H
+#define BLACKBOX_BAKEDASSETS_H
+
+// assets compiled into the executable by blackbox-bake (see CMakeLists.txt)
+
+// a vertex as the irrlicht obj loader would produce it (x mirrored, texture v flipped)
+struct BakedVertex {
+	float pos[3];
+	float normal[3];
+	float uv[2];
+};
+
+// a mesh with a single material, triangles in the winding the obj loader produces
+struct BakedMesh {
+	const BakedVertex* vertices;
+	unsigned int vertexCount;
+	const unsigned short* indices;
+	unsigned int indexCount;
+	// material colors as argb
+	unsigned int ambient;
+	unsigned int diffuse;
+	unsigned int specular;
+	float shininess;
+};
+
+// the unchanged bytes of a file
+struct BakedFile {
+	const unsigned char* data;
+	unsigned int size;
+};
+
+extern const BakedMesh cubeMesh;
+extern const BakedMesh atomMesh;
+extern const BakedFile helpImage;
+
+#endif
@@ -0,0 +1,342 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "benchsuite.h"
+#include "game.h"
+#include "pcgrandom.h"
+#include "raybatch.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+struct Options {
+	int size = 8;
+	int atoms = 5;
+	int boards = 100000;
+	bool check = false;
+	bool suite = false;
+	double minSeconds = 0.05;
+	double margin = 0.1;
+	std::string json;
+	std::string baseline;
+};
+
+void usage() {
+	std::cerr << "usage: blackbox-bench [-s size] [-a atoms] [-b boards] [--check]" << std::endl;
+	std::cerr << "  measures rays per second of the ray engine and the batch kernel" << std::endl;
+	std::cerr << "  --check compares the batch kernel with the ray engine on random boards of all sizes instead" << std::endl;
+	std::cerr << "       blackbox-bench --suite [--json file] [--baseline file] [--margin 0.1] [--min-time seconds]" << std::endl;
+	std::cerr << "  --suite times the hot paths on all board sizes and some atom counts, --json writes the times" << std::endl;
+	std::cerr << "  and --baseline fails if a case got slower than the stored times by more than the margin" << std::endl;
+}
+
+
+template <int Words>
+std::vector<typename BasicBlackboxBoard<Words>::Bits> randomBoards(int size, int atoms, int count, Pcg32& rng) {
+	std::vector<typename BasicBlackboxBoard<Words>::Bits> boards(count);
+	std::vector<int> order;
+	resetCells(order, size*size);
+	for (auto & bits : boards) {
+		randomAtoms(rng, order, atoms, bits);
+	}
+	return boards;
+}
+
+// every entry of every board, with the reference engine and with the batch in both modes
+template <int Words>
+int check(int size, Pcg32& rng) {
+	const int entries = 4*size;
+	const int boards = 200;
+	BasicRayEngine<Words> engine(size);
+	BasicRayBatch<Words> vectorBatch(size);
+	BasicRayBatch<Words> scalarBatch(size, false);
+	std::vector<RayResult> all(boards*entries);
+	std::vector<RayResult> column(boards);
+	int mismatches = 0;
+
+	for (int atoms = 0; atoms <= std::min(size*size, 12); atoms += 3) {
+		auto bits = randomBoards<Words>(size, atoms ? atoms : rng.below(std::min(size*size, 12) + 1), boards, rng);
+		for (int pass = 0; pass < 2; ++pass) {
+			BasicRayBatch<Words>& batch = pass ? scalarBatch : vectorBatch;
+			batch.traceAll(bits.data(), boards, all.data());
+			for (int b = 0; b < boards; ++b) {
+				engine.update(bits[b]);
+				for (int entry = 0; entry < entries; ++entry) {
+					mismatches += all[b*entries + entry] != engine.trace(entry);
+				}
+			}
+			for (int entry = 0; entry < entries; ++entry) {
+				batch.traceBoards(bits.data(), boards, entry, column.data());
+				for (int b = 0; b < boards; ++b) {
+					engine.update(bits[b]);
+					mismatches += column[b] != engine.trace(entry);
+				}
+			}
+		}
+	}
+	if (mismatches) {
+		std::cerr << size << "x" << size << ": " << mismatches << " mismatches" << std::endl;
+	}
+	return mismatches;
+}
+
+int checkAll() {
+	Pcg32 rng(1);
+	int mismatches = 0;
+	for (int size = 1; size <= 64; ++size) {
+		if (size*size <= 64) {
+			mismatches += check<1>(size, rng);
+		} else if (size*size <= 256) {
+			mismatches += check<4>(size, rng);
+		} else if (size*size <= 1024) {
+			mismatches += check<16>(size, rng);
+		} else if (size % 8 == 0) {
+			mismatches += check<64>(size, rng);
+		}
+	}
+	std::cout << (BasicRayBatch<1>(1).vectorized() ? "avx2" : "scalar (no avx2)") << " kernel: "
+		<< (mismatches ? "mismatches found" : "all outcomes match") << std::endl;
+	return mismatches ? 1 : 0;
+}
+
+template <class F>
+void measure(const char* name, std::uint64_t rays, F f) {
+	auto start = std::chrono::steady_clock::now();
+	f();
+	std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+	std::cout << name << ": " << rays / seconds.count() / 1e6 << " M rays/s" << std::endl;
+}
+
+template <int Words>
+void bench(const Options& options) {
+	Pcg32 rng(1);
+	auto boards = randomBoards<Words>(options.size, options.atoms, options.boards, rng);
+	const int entries = 4*options.size;
+	const std::uint64_t rays = std::uint64_t(entries) * options.boards;
+	std::vector<RayResult> results(std::uint64_t(entries) * options.boards);
+	// boards per call of traceAll
+	const int chunk = 256;
+	// keeps the compiler from dropping the work
+	int hits = 0;
+
+	measure("engine, all entries", rays, [&]() {
+		BasicRayEngine<Words> engine(options.size);
+		for (auto & bits : boards) {
+			engine.update(bits);
+			for (int entry = 0; entry < entries; ++entry) {
+				hits += engine.trace(entry).outcome == RAY_HIT;
+			}
+		}
+	});
+	BasicRayBatch<Words> vectorBatch(options.size);
+	BasicRayBatch<Words> scalarBatch(options.size, false);
+	for (int pass = 0; pass < 2; ++pass) {
+		BasicRayBatch<Words>& batch = pass ? scalarBatch : vectorBatch;
+		if (!pass && !batch.vectorized()) {
+			std::cout << "no avx2 or a board wider than 8x8, the batch runs the scalar engine" << std::endl;
+			continue;
+		}
+		measure(pass ? "scalar batch, all entries" : "avx2 batch, all entries", rays, [&]() {
+			for (int b = 0; b < options.boards; b += chunk) {
+				batch.traceAll(boards.data() + b, std::min(chunk, options.boards - b), results.data());
+				hits += results[0].outcome == RAY_HIT;
+			}
+		});
+		measure(pass ? "scalar batch, entry by entry" : "avx2 batch, entry by entry", rays, [&]() {
+			for (int entry = 0; entry < entries; ++entry) {
+				batch.traceBoards(boards.data(), options.boards, entry, results.data());
+				hits += results[0].outcome == RAY_HIT;
+			}
+		});
+	}
+	if (hits < 0) {
+		std::cout << hits << std::endl;
+	}
+}
+
+// keeps the compiler from dropping the work of the suite
+volatile int sink;
+
+// the cases of the ray logic for one board size and atom count
+template <int Words>
+void suiteCases(BenchSuite& suite, int size, int atoms) {
+	const int entries = 4*size;
+	const int boardCount = 64;
+	Pcg32 rng(size*1000 + atoms);
+	auto boards = randomBoards<Words>(size, atoms, boardCount, rng);
+
+	// a single ray on boards whose masks are ready, the latency of a click on a new raycube
+	std::vector<BasicRayEngine<Words>> engines(boardCount, BasicRayEngine<Words>(size));
+	for (int b = 0; b < boardCount; ++b) {
+		engines[b].update(boards[b]);
+	}
+	suite.run(benchName("trace", size, atoms), [&](std::uint64_t count) {
+		int hits = 0;
+		int entry = 0, board = 0;
+		for (std::uint64_t i = 0; i < count; ++i) {
+			hits += engines[board].trace(entry).outcome == RAY_HIT;
+			if (++entry == entries) {
+				entry = 0;
+				board = (board + 1) % boardCount;
+			}
+		}
+		sink = hits;
+	});
+
+	// all rays of many boards at once (per ray), as the generator and the hints trace them
+	BasicRayBatch<Words> batch(size);
+	std::vector<RayResult> results(boardCount*entries);
+	suite.run(benchName("batch", size, atoms), [&](std::uint64_t count) {
+		int hits = 0;
+		// count rays are the whole rays of count/entries boards
+		for (std::uint64_t left = (count + entries-1) / entries; left > 0; ) {
+			int group = std::min<std::uint64_t>(left, boardCount);
+			batch.traceAll(boards.data(), group, results.data());
+			hits += results[0].outcome == RAY_HIT;
+			left -= group;
+		}
+		sink = hits;
+	});
+}
+
+void suiteGameCases(BenchSuite& suite, int size, int atoms) {
+	Game game(size, atoms, 1);
+	// new random atoms, what the reset button does
+	suite.run(benchName("reset", size, atoms), [&](std::uint64_t count) {
+		for (std::uint64_t i = 0; i < count; ++i) {
+			game.reset();
+		}
+		sink = game.atoms();
+	});
+
+	// a guessed atom placed and removed again (per click)
+	Pcg32 rng(size);
+	std::vector<int> cells(1024);
+	for (auto & cell : cells) {
+		cell = rng.below(size*size);
+	}
+	game.reset();
+	suite.run(benchName("place", size, atoms), [&](std::uint64_t count) {
+		int changed = 0;
+		for (std::uint64_t i = 0; i < count; i += 2) {
+			int cell = cells[(i/2) % cells.size()];
+			changed += game.placeAtom(cell);
+			changed += game.removeAtom(cell);
+		}
+		sink = changed;
+	});
+
+	// a whole game: new atoms and a ray from every raycube, through the lazily filled ray table
+	suite.run(benchName("game", size, atoms), [&](std::uint64_t count) {
+		int fired = 0;
+		for (std::uint64_t i = 0; i < count; ++i) {
+			game.reset();
+			for (int entry = 0; entry < 4*size; ++entry) {
+				fired += game.fire(entry);
+			}
+			game.evaluate();
+		}
+		sink = fired;
+	});
+}
+
+int runSuite(const Options& options) {
+	BenchSuite suite(options.minSeconds);
+	for (int size : {4, 8, 16, 32, 64}) {
+		for (int atoms : {5, 2*size}) {
+			if (size*size <= 64) {
+				suiteCases<1>(suite, size, atoms);
+			} else if (size*size <= 256) {
+				suiteCases<4>(suite, size, atoms);
+			} else if (size*size <= 1024) {
+				suiteCases<16>(suite, size, atoms);
+			} else {
+				suiteCases<64>(suite, size, atoms);
+			}
+			suiteGameCases(suite, size, atoms);
+		}
+	}
+	if (!options.json.empty() && !suite.writeJson(options.json)) {
+		std::cerr << "could not write " << options.json << std::endl;
+		return 1;
+	}
+	if (!options.baseline.empty()) {
+		int slower = suite.compare(options.baseline, options.margin, std::cout);
+		if (slower < 0) {
+			std::cerr << "could not read " << options.baseline << std::endl;
+			return 1;
+		}
+		if (slower > 0) {
+			std::cout << slower << " cases are more than " << 100*options.margin << "% slower than the baseline" << std::endl;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+}
+
+int main(int argc, char** argv) {
+	Options options;
+	for (int i = 1; i < argc; ++i) {
+		if (!std::strcmp(argv[i], "-s") && i+1 < argc) {
+			options.size = std::atoi(argv[++i]);
+		} else if (!std::strcmp(argv[i], "-a") && i+1 < argc) {
+			options.atoms = std::atoi(argv[++i]);
+		} else if (!std::strcmp(argv[i], "-b") && i+1 < argc) {
+			options.boards = std::atoi(argv[++i]);
+		} else if (!std::strcmp(argv[i], "--check")) {
+			options.check = true;
+		} else if (!std::strcmp(argv[i], "--suite")) {
+			options.suite = true;
+		} else if (!std::strcmp(argv[i], "--json") && i+1 < argc) {
+			options.json = argv[++i];
+		} else if (!std::strcmp(argv[i], "--baseline") && i+1 < argc) {
+			options.baseline = argv[++i];
+		} else if (!std::strcmp(argv[i], "--margin") && i+1 < argc) {
+			options.margin = std::atof(argv[++i]);
+		} else if (!std::strcmp(argv[i], "--min-time") && i+1 < argc) {
+			options.minSeconds = std::atof(argv[++i]);
+		} else {
+			usage();
+			return 1;
+		}
+	}
+	if (options.check) {
+		return checkAll();
+	}
+	if (options.suite) {
+		return runSuite(options);
+	}
+	if (options.size < 1 || options.size*options.size > WideBlackboxBoard::maxCells
+	|| options.atoms < 0 || options.atoms > options.size*options.size || options.boards < 1) {
+		usage();
+		return 1;
+	}
+	std::cout << options.boards << " boards " << options.size << "x" << options.size << " with " << options.atoms << " atoms" << std::endl;
+	if (options.size*options.size <= BlackboxBoard::maxCells) {
+		bench<1>(options);
+	} else {
+		bench<4>(options);
+	}
+	return 0;
+}
@@ -0,0 +1,192 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <irrlicht.h>
+#include "assets.h"
+#include "benchsuite.h"
+#include "boardnode.h"
+#include "boardview.h"
+#include "game.h"
+#include "picker.h"
+#include "tournament.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace irr;
+
+namespace {
+
+struct Options {
+	double minSeconds = 0.05;
+	double margin = 0.1;
+	std::string json;
+	std::string baseline;
+};
+
+void usage() {
+	std::cerr << "usage: blackbox-bench-scene [--json file] [--baseline file] [--margin 0.1] [--min-time seconds]" << std::endl;
+	std::cerr << "  times picking and whole frames on the null driver on all board sizes and with several boards" << std::endl;
+	std::cerr << "  (see blackbox-bench --suite)" << std::endl;
+}
+
+volatile int sink;
+
+// the cases of the scene for one board size and atom count, on the null driver
+void sceneCases(BenchSuite& suite, IrrlichtDevice* device, int size, int atoms) {
+	video::IVideoDriver* driver = device->getVideoDriver();
+	scene::ISceneManager* smgr = device->getSceneManager();
+	smgr->clear();
+	smgr->setAmbientLight(video::SColorf(1,1,1));
+
+	const float offset = -(3*size)/2;
+	scene::SMesh* cube = createBakedMesh(cubeMesh);
+	scene::SMesh* atom = createBakedMesh(atomMesh);
+	BoardSceneNode* boardNode = new BoardSceneNode(smgr->getRootSceneNode(), smgr, size, offset, cube, atom, cubeColor, raycubeColor, atomColor);
+	boardNode->drop();
+	scene::ICameraSceneNode* camera = smgr->addCameraSceneNode(0, core::vector3df(0,-cameraDistance(size),0), core::vector3df(0,0,0));
+	BoardPicker picker(size, offset, cube->getBoundingBox().getExtent().X/2);
+	cube->drop();
+	atom->drop();
+	// the first draw updates the camera, the rays of the clicks depend on it
+	smgr->drawAll();
+
+	// mouse positions all over the window, turned into rays like the main loop does
+	const core::dimension2du screen = driver->getScreenSize();
+	scene::ISceneCollisionManager* collmgr = smgr->getSceneCollisionManager();
+	std::vector<core::line3df> clicks;
+	for (u32 y = 0; y < screen.Height; y += 16) {
+		for (u32 x = 0; x < screen.Width; x += 16) {
+			clicks.push_back(collmgr->getRayFromScreenCoordinates(core::position2di(x, y), camera));
+		}
+	}
+	suite.run(benchName("pick", size, atoms), [&](std::uint64_t count) {
+		int cells = 0;
+		for (std::uint64_t i = 0; i < count; ++i) {
+			cells += picker.pick(clicks[i % clicks.size()]).kind == BoardPicker::PICK_CELL;
+		}
+		sink = cells;
+	});
+
+	// a click on a raycube: the ray, the colors and a frame
+	Game game(size, atoms, 1);
+	int entry = 0;
+	suite.run(benchName("frame_ray", size, atoms), [&](std::uint64_t count) {
+		for (std::uint64_t i = 0; i < count; ++i) {
+			if (entry == 4*size) {
+				game.reset();
+				entry = 0;
+			}
+			game.fire(entry++);
+			showGame(game, boardNode);
+			driver->beginScene(true, true, video::SColor(255,150,150,255));
+			smgr->drawAll();
+			driver->endScene();
+		}
+	});
+
+	// the reset button: new atoms, all colors back and a frame
+	suite.run(benchName("frame_reset", size, atoms), [&](std::uint64_t count) {
+		for (std::uint64_t i = 0; i < count; ++i) {
+			game.reset();
+			showGame(game, boardNode);
+			driver->beginScene(true, true, video::SColor(255,150,150,255));
+			smgr->drawAll();
+			driver->endScene();
+		}
+	});
+}
+
+// all boards of a tournament get new atoms and a frame is drawn, more boards should cost far less than
+// as many frames
+void tournamentCases(BenchSuite& suite, IrrlichtDevice* device, int boards, int size) {
+	video::IVideoDriver* driver = device->getVideoDriver();
+	scene::ISceneManager* smgr = device->getSceneManager();
+	smgr->clear();
+	smgr->setAmbientLight(video::SColorf(1,1,1));
+	scene::SMesh* cube = createBakedMesh(cubeMesh);
+	scene::SMesh* atom = createBakedMesh(atomMesh);
+	Tournament tournament(smgr, boards, size, cube, atom, 1);
+	cube->drop();
+	atom->drop();
+	smgr->addCameraSceneNode(0, core::vector3df(0,-tournament.cameraDistance(),0), core::vector3df(0,0,0));
+	tournament.update();
+
+	suite.run(benchName("frame_reset_boards" + std::to_string(boards), size, 5), [&](std::uint64_t count) {
+		for (std::uint64_t i = 0; i < count; ++i) {
+			tournament.resetAll();
+			tournament.update();
+			driver->beginScene(true, true, video::SColor(255,150,150,255));
+			smgr->drawAll();
+			driver->endScene();
+		}
+	});
+}
+
+}
+
+int main(int argc, char** argv) {
+	Options options;
+	for (int i = 1; i < argc; ++i) {
+		if (!std::strcmp(argv[i], "--json") && i+1 < argc) {
+			options.json = argv[++i];
+		} else if (!std::strcmp(argv[i], "--baseline") && i+1 < argc) {
+			options.baseline = argv[++i];
+		} else if (!std::strcmp(argv[i], "--margin") && i+1 < argc) {
+			options.margin = std::atof(argv[++i]);
+		} else if (!std::strcmp(argv[i], "--min-time") && i+1 < argc) {
+			options.minSeconds = std::atof(argv[++i]);
+		} else {
+			usage();
+			return 1;
+		}
+	}
+
+	IrrlichtDevice* device = createDevice(video::EDT_NULL, core::dimension2du(1024,768));
+	if (!device) {
+		return 1;
+	}
+	BenchSuite suite(options.minSeconds);
+	for (int size : {4, 8, 16, 32, 64}) {
+		for (int atoms : {5, 2*size}) {
+			sceneCases(suite, device, size, atoms);
+		}
+	}
+	for (int boards : {1, 4, 16}) {
+		tournamentCases(suite, device, boards, 8);
+	}
+	device->drop();
+
+	if (!options.json.empty() && !suite.writeJson(options.json)) {
+		std::cerr << "could not write " << options.json << std::endl;
+		return 1;
+	}
+	if (!options.baseline.empty()) {
+		int slower = suite.compare(options.baseline, options.margin, std::cout);
+		if (slower < 0) {
+			std::cerr << "could not read " << options.baseline << std::endl;
+			return 1;
+		}
+		if (slower > 0) {
+			std::cout << slower << " cases are more than " << 100*options.margin << "% slower than the baseline" << std::endl;
+			return 1;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,99 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "benchsuite.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+double BenchSuite::median(std::vector<double>& values) {
+	std::sort(values.begin(), values.end());
+	return values[values.size()/2];
+}
+
+void BenchSuite::add(const std::string& name, double nanoseconds) {
+	Result result = {name, nanoseconds};
+	all.push_back(result);
+	std::cout << std::left << std::setw(40) << name << std::right << std::setw(14) << std::fixed << std::setprecision(1)
+		<< nanoseconds << " ns/op" << std::setw(14) << std::setprecision(3) << 1e3 / nanoseconds << " M ops/s" << std::endl;
+}
+
+bool BenchSuite::writeJson(const std::string& path) const {
+	std::ofstream file(path);
+	if (!file) {
+		return false;
+	}
+	file << "{\"benchmarks\": [";
+	for (std::size_t i = 0; i < all.size(); ++i) {
+		file << (i ? ",\n" : "\n") << "  {\"name\": \"" << all[i].name << "\", \"ns_per_op\": "
+			<< std::setprecision(6) << all[i].nanoseconds << "}";
+	}
+	file << "\n]}\n";
+	return static_cast<bool>(file);
+}
+
+int BenchSuite::compare(const std::string& baselinePath, double margin, std::ostream& out) const {
+	std::ifstream file(baselinePath);
+	if (!file) {
+		return -1;
+	}
+	std::stringstream text;
+	text << file.rdbuf();
+	const std::string json = text.str();
+
+	// only reads what writeJson writes: a name followed by its time
+	std::map<std::string, double> baseline;
+	for (std::size_t at = json.find("\"name\""); at != std::string::npos; at = json.find("\"name\"", at)) {
+		std::size_t open = json.find('"', json.find(':', at) + 1);
+		std::size_t close = json.find('"', open + 1);
+		std::size_t value = json.find("\"ns_per_op\"", close);
+		if (open == std::string::npos || close == std::string::npos || value == std::string::npos) {
+			return -1;
+		}
+		baseline[json.substr(open + 1, close - open - 1)] = std::strtod(json.c_str() + json.find(':', value) + 1, 0);
+		at = close;
+	}
+	if (baseline.empty()) {
+		return -1;
+	}
+
+	int slower = 0;
+	out << std::fixed << std::setprecision(1);
+	for (auto & result : all) {
+		auto old = baseline.find(result.name);
+		if (old == baseline.end()) {
+			out << std::left << std::setw(40) << result.name << std::right << "  no baseline" << std::endl;
+			continue;
+		}
+		double change = result.nanoseconds / old->second - 1;
+		bool regressed = change > margin;
+		slower += regressed;
+		out << std::left << std::setw(40) << result.name << std::right << std::setw(12) << old->second << " -> "
+			<< std::setw(12) << result.nanoseconds << " ns/op" << std::setw(9) << std::showpos << 100*change << std::noshowpos << "%"
+			<< (regressed ? "  REGRESSION" : "") << std::endl;
+	}
+	return slower;
+}
+
+std::string benchName(const std::string& name, int size, int atoms) {
+	return name + "/size=" + std::to_string(size) + "/atoms=" + std::to_string(atoms);
+}
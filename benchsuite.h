@@ -0,0 +1,85 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BLACKBOX_BENCHSUITE_H
+#define BLACKBOX_BENCHSUITE_H
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// times benchmark cases, writes them as json and compares them with a stored baseline
+// a case is a function that runs a given number of operations; it is run with growing counts until a run
+// takes long enough and then timed a few more times, the median time per operation is kept
+class BenchSuite {
+public:
+	struct Result {
+		std::string name;
+		double nanoseconds;	// per operation
+	};
+
+	// seconds a single timed run should at least take
+	explicit BenchSuite(double minSeconds = 0.05): minSeconds(minSeconds) {}
+
+	template <class F>
+	void run(const std::string& name, F f) {
+		std::uint64_t count = 1;
+		while (time(f, count) < minSeconds && count < (std::uint64_t(1) << 40)) {
+			count *= 4;
+		}
+		std::vector<double> times;
+		for (int i = 0; i < repetitions; ++i) {
+			times.push_back(time(f, count));
+		}
+		add(name, median(times) * 1e9 / count);
+	}
+
+	const std::vector<Result>& results() const {
+		return all;
+	}
+
+	// {"benchmarks": [{"name": ..., "ns_per_op": ...}, ...]}
+	bool writeJson(const std::string& path) const;
+
+	// prints every case next to its baseline, returns the number of cases that are slower than
+	// the baseline by more than margin (0.1 for 10%), or -1 if the baseline cannot be read
+	int compare(const std::string& baselinePath, double margin, std::ostream& out) const;
+
+private:
+	static const int repetitions = 5;
+
+	template <class F>
+	static double time(F& f, std::uint64_t count) {
+		auto start = std::chrono::steady_clock::now();
+		f(count);
+		std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+		return seconds.count();
+	}
+
+	static double median(std::vector<double>& values);
+	void add(const std::string& name, double nanoseconds);
+
+	double minSeconds;
+	std::vector<Result> all;
+};
+
+// the name of a case for a board size and atom count, e.g. "trace/size=8/atoms=5"
+std::string benchName(const std::string& name, int size, int atoms);
+
+#endif
@@ -0,0 +1,99 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BLACKBOX_BITBOARD_H
+#define BLACKBOX_BITBOARD_H
+
+#include <array>
+#include <cstdint>
+
+// fixed size set of bits, one bit per board cell (a single word holds an 8x8 board)
+template <int Words>
+class Bitboard {
+public:
+	static const int bits = 64*Words;
+
+	Bitboard() {
+		clear();
+	}
+
+	void clear() {
+		words.fill(0);
+	}
+
+	bool test(int i) const {
+		return (words[i >> 6] >> (i & 63)) & 1;
+	}
+
+	void set(int i) {
+		words[i >> 6] |= std::uint64_t(1) << (i & 63);
+	}
+
+	void reset(int i) {
+		words[i >> 6] &= ~(std::uint64_t(1) << (i & 63));
+	}
+
+	bool any() const {
+		for (int i = 0; i < Words; ++i) {
+			if (words[i]) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	int count() const {
+		int n = 0;
+		for (int i = 0; i < Words; ++i) {
+			n += __builtin_popcountll(words[i]);
+		}
+		return n;
+	}
+
+	bool intersects(const Bitboard& other) const {
+		for (int i = 0; i < Words; ++i) {
+			if (words[i] & other.words[i]) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// call f(bit) for every set bit in ascending order
+	template <class F>
+	void forEach(F f) const {
+		for (int i = 0; i < Words; ++i) {
+			std::uint64_t w = words[i];
+			while (w) {
+				f(64*i + __builtin_ctzll(w));
+				w &= w - 1;
+			}
+		}
+	}
+
+	bool operator==(const Bitboard& other) const {
+		return words == other.words;
+	}
+
+	bool operator!=(const Bitboard& other) const {
+		return words != other.words;
+	}
+
+	std::array<std::uint64_t, Words> words;
+};
+
+#endif
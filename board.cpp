@@ -0,0 +1,38 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "board.h"
+#include <stdexcept>
+
+template <int Words>
+BasicBlackboxBoard<Words>::BasicBlackboxBoard(int size): boardSize(size) {
+	if (size < 1 || size*size > maxCells) {
+		throw std::invalid_argument("board size does not fit the bitboard");
+	}
+}
+
+template <int Words>
+std::vector<int> BasicBlackboxBoard<Words>::atomPositions() const {
+	std::vector<int> positions;
+	atomBits.forEach([&](int cell) { positions.push_back(cell); });
+	return positions;
+}
+
+template class BasicBlackboxBoard<1>;
+template class BasicBlackboxBoard<4>;
+template class BasicBlackboxBoard<16>;
+template class BasicBlackboxBoard<64>;
@@ -0,0 +1,86 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BLACKBOX_BOARD_H
+#define BLACKBOX_BOARD_H
+
+#include "bitboard.h"
+#include <vector>
+
+// the hidden atoms of a square gameboard
+// cell ids are x*size+y where x and y are the coordinates used by the ray logic,
+// which is the same id the gameboard cubes carry in the scene
+template <int Words>
+class BasicBlackboxBoard {
+public:
+	typedef Bitboard<Words> Bits;
+	static const int maxCells = Bits::bits;
+
+	explicit BasicBlackboxBoard(int size);
+
+	int size() const {
+		return boardSize;
+	}
+
+	int cells() const {
+		return boardSize*boardSize;
+	}
+
+	bool hasAtom(int cell) const {
+		return atomBits.test(cell);
+	}
+
+	bool hasAtom(int x, int y) const {
+		return x >= 0 && x < boardSize && y >= 0 && y < boardSize && atomBits.test(x*boardSize+y);
+	}
+
+	void setAtom(int cell) {
+		atomBits.set(cell);
+	}
+
+	void removeAtom(int cell) {
+		atomBits.reset(cell);
+	}
+
+	void clear() {
+		atomBits.clear();
+	}
+
+	int atomCount() const {
+		return atomBits.count();
+	}
+
+	const Bits& atoms() const {
+		return atomBits;
+	}
+
+	// cell ids of all atoms in ascending order
+	std::vector<int> atomPositions() const;
+
+private:
+	int boardSize;
+	Bits atomBits;
+};
+
+// a single word is enough for the default 8x8 board
+typedef BasicBlackboxBoard<1> BlackboxBoard;
+// wider bitset for boards up to 16x16
+typedef BasicBlackboxBoard<4> WideBlackboxBoard;
+// the board, engine and table are also built for 16 words (32x32) and 64 words (64x64),
+// see GameBoard for picking one of them at runtime
+
+#endif
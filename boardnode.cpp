@@ -0,0 +1,323 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "boardnode.h"
+#include <algorithm>
+
+using namespace irr;
+
+namespace {
+// distance between neighbouring cubes and between the border cubes and their raycubes
+const float cubeSpacing = 3;
+const float raycubeDistance = 5;
+// texels per row of the state texture
+const u32 stateWidth = 64;
+
+// without lights the fixed function output is the ambient colour, which is the colour of the cube
+const c8* stateVertexShader =
+	"void main() {\n"
+	"	gl_Position = ftransform();\n"
+	"	gl_TexCoord[0] = gl_MultiTexCoord0;\n"
+	"}\n";
+const c8* statePixelShader =
+	"uniform sampler2D boardState;\n"
+	"void main() {\n"
+	"	gl_FragColor = texture2D(boardState, gl_TexCoord[0].xy);\n"
+	"}\n";
+
+class StateCallback : public video::IShaderConstantSetCallBack {
+public:
+	virtual void OnSetConstants(video::IMaterialRendererServices* services, s32 /*userData*/) {
+		s32 layer = 0;
+		services->setPixelShaderConstant("boardState", &layer, 1);
+	}
+};
+}
+
+BoardSceneNode::BoardSceneNode(scene::ISceneNode* parent, scene::ISceneManager* mgr, int size, float offset,
+	scene::IMesh* cube, scene::IMesh* atom, video::SColor cubeColor, video::SColor raycubeColor, video::SColor atomColor):
+	scene::ISceneNode(parent, mgr), boardSize(size), boardOffset(offset), atomVisible(size*size, false), atomsDirty(true),
+	stateTexture(0), statesDirty(true), changed(true) {
+	cubeScale = cube->getBoundingBox().getExtent().X/2;
+	cubes = new scene::CDynamicMeshBuffer(video::EVT_STANDARD, video::EIT_32BIT);
+	atoms = new scene::CDynamicMeshBuffer(video::EVT_STANDARD, video::EIT_32BIT);
+
+	// the same material the single cube nodes had, but the ambient colour comes from the vertices
+	for (scene::CDynamicMeshBuffer* buffer : {cubes, atoms}) {
+		video::SMaterial& material = buffer->getMaterial();
+		material = (buffer == cubes ? cube : atom)->getMeshBuffer(0)->getMaterial();
+		material.setFlag(video::EMF_LIGHTING, true);
+		material.setFlag(video::EMF_BILINEAR_FILTER, false);
+		material.Shininess = 20.0f;
+		material.ColorMaterial = video::ECM_AMBIENT;
+	}
+
+	cubeVertices = 0;
+	for (u32 i = 0; i < cube->getMeshBufferCount(); ++i) {
+		cubeVertices += cube->getMeshBuffer(i)->getVertexCount();
+	}
+	// gameboard cubes first (in cell order), then the raycubes (in entry order)
+	box.reset(getCubePosition(0));
+	for (int cell = 0; cell < size*size; ++cell) {
+		addInstance(cubes, cube, getCubePosition(cell), cubeColor);
+	}
+	for (int entry = 0; entry < 4*size; ++entry) {
+		addInstance(cubes, cube, getRaycubePosition(entry), raycubeColor);
+	}
+	states.assign(size*size, cubeColor);
+	states.resize(size*size + 4*size, raycubeColor);
+	createStateTexture();
+
+	// only visible atoms are in the atom buffer (a few, even on large boards), it is rebuilt from a
+	// single atom at the origin whenever an atom is shown or hidden
+	addInstance(atoms, atom, core::vector3df(0,-1,0), atomColor);
+	scene::IVertexBuffer& vertices = atoms->getVertexBuffer();
+	scene::IIndexBuffer& indices = atoms->getIndexBuffer();
+	for (u32 i = 0; i < vertices.size(); ++i) {
+		atomVertices.push_back(vertices[i]);
+	}
+	for (u32 i = 0; i < indices.size(); ++i) {
+		atomIndices.push_back(indices[i]);
+	}
+	vertices.set_used(0);
+	indices.set_used(0);
+
+	cubes->setBoundingBox(box);
+	atoms->setBoundingBox(box);
+	cubes->setHardwareMappingHint(scene::EHM_STATIC);
+	atoms->setHardwareMappingHint(scene::EHM_STATIC);
+}
+
+BoardSceneNode::~BoardSceneNode() {
+	cubes->drop();
+	atoms->drop();
+	if (stateTexture) {
+		SceneManager->getVideoDriver()->removeTexture(stateTexture);
+	}
+}
+
+bool BoardSceneNode::createStateTexture() {
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+	if (driver->getDriverType() != video::EDT_OPENGL || !driver->queryFeature(video::EVDF_ARB_GLSL)) {
+		return false;
+	}
+	StateCallback* callback = new StateCallback();
+	s32 material = driver->getGPUProgrammingServices()->addHighLevelShaderMaterial(
+		stateVertexShader, "main", video::EVST_VS_1_1, statePixelShader, "main", video::EPST_PS_1_1, callback);
+	callback->drop();
+	if (material < 0) {
+		return false;
+	}
+
+	// a power of two high, so drivers without npot textures do not scale it
+	u32 rows = (states.size() + stateWidth-1) / stateWidth;
+	u32 height = 1;
+	while (height < rows) {
+		height *= 2;
+	}
+	bool mipMaps = driver->getTextureCreationFlag(video::ETCF_CREATE_MIP_MAPS);
+	driver->setTextureCreationFlag(video::ETCF_CREATE_MIP_MAPS, false);
+	// textures are looked up by name, every board gets its own
+	static u32 boards = 0;
+	core::stringc name = "boardstate";
+	name += boards++;
+	stateTexture = driver->addTexture(core::dimension2du(stateWidth, height), name, video::ECF_A8R8G8B8);
+	driver->setTextureCreationFlag(video::ETCF_CREATE_MIP_MAPS, mipMaps);
+	if (!stateTexture) {
+		return false;
+	}
+
+	// every vertex of a cube points at the texel of the cube
+	scene::IVertexBuffer& vertices = cubes->getVertexBuffer();
+	for (u32 v = 0; v < vertices.size(); ++v) {
+		u32 instance = v / cubeVertices;
+		vertices[v].TCoords = core::vector2df((instance % stateWidth + 0.5f) / stateWidth, (instance / stateWidth + 0.5f) / height);
+	}
+	video::SMaterial& cubeMaterial = cubes->getMaterial();
+	cubeMaterial.MaterialType = static_cast<video::E_MATERIAL_TYPE>(material);
+	cubeMaterial.setTexture(0, stateTexture);
+	cubeMaterial.TextureLayer[0].TextureWrapU = video::ETC_CLAMP_TO_EDGE;
+	cubeMaterial.TextureLayer[0].TextureWrapV = video::ETC_CLAMP_TO_EDGE;
+	statesDirty = true;
+	return true;
+}
+
+void BoardSceneNode::uploadStates() {
+	u8* texels = static_cast<u8*>(stateTexture->lock(video::ETLM_WRITE_ONLY));
+	if (!texels) {
+		return;
+	}
+	const u32 pitch = stateTexture->getPitch();
+	for (u32 first = 0; first < states.size(); first += stateWidth) {
+		u32 count = std::min<u32>(stateWidth, states.size() - first);
+		u32* row = reinterpret_cast<u32*>(texels + (first / stateWidth) * pitch);
+		for (u32 i = 0; i < count; ++i) {
+			row[i] = states[first + i].color;
+		}
+	}
+	stateTexture->unlock();
+	statesDirty = false;
+}
+
+core::vector3df BoardSceneNode::getCubePosition(int cell) const {
+	int x = cell % boardSize;
+	int y = cell / boardSize;
+	return core::vector3df(boardOffset + cubeSpacing*x + cubeScale, 0, boardOffset + cubeSpacing*y + cubeScale + 0.5f);
+}
+
+core::vector3df BoardSceneNode::getRaycubePosition(int entry) const {
+	int side = entry / boardSize;
+	int index = entry % boardSize;
+	if (side == 0) {
+		return getCubePosition(index) + core::vector3df(0,0,-raycubeDistance);
+	} else if (side == 1) {
+		return getCubePosition((boardSize-1)*boardSize+index) + core::vector3df(0,0,raycubeDistance);
+	} else if (side == 2) {
+		return getCubePosition(index*boardSize) + core::vector3df(-raycubeDistance,0,0);
+	}
+	return getCubePosition(index*boardSize+boardSize-1) + core::vector3df(raycubeDistance,0,0);
+}
+
+void BoardSceneNode::addInstance(scene::CDynamicMeshBuffer* buffer, scene::IMesh* mesh, const core::vector3df& position, video::SColor color) {
+	// correct Blender rotation for Irrlicht (not really necessary for a cube, just for reference)
+	core::matrix4 transform;
+	transform.setRotationDegrees(core::vector3df(0,0,180));
+	transform.setTranslation(position);
+
+	scene::IVertexBuffer& vertices = buffer->getVertexBuffer();
+	scene::IIndexBuffer& indices = buffer->getIndexBuffer();
+	for (u32 i = 0; i < mesh->getMeshBufferCount(); ++i) {
+		scene::IMeshBuffer* source = mesh->getMeshBuffer(i);
+		const video::S3DVertex* sourceVertices = static_cast<const video::S3DVertex*>(source->getVertices());
+		const u32 first = vertices.size();
+		for (u32 v = 0; v < source->getVertexCount(); ++v) {
+			video::S3DVertex vertex = sourceVertices[v];
+			transform.transformVect(vertex.Pos);
+			transform.rotateVect(vertex.Normal);
+			vertex.Color = color;
+			vertices.push_back(vertex);
+			box.addInternalPoint(vertex.Pos);
+		}
+		for (u32 j = 0; j < source->getIndexCount(); ++j) {
+			indices.push_back(first + source->getIndices()[j]);
+		}
+	}
+}
+
+void BoardSceneNode::setInstanceColor(int instance, video::SColor color) {
+	if (states[instance] == color) {
+		return;
+	}
+	states[instance] = color;
+	changed = true;
+	if (stateTexture) {
+		// uploaded once before the next draw, however many cubes changed
+		statesDirty = true;
+		return;
+	}
+	scene::IVertexBuffer& vertexBuffer = cubes->getVertexBuffer();
+	for (u32 v = instance*cubeVertices; v < (instance+1)*cubeVertices; ++v) {
+		vertexBuffer[v].Color = color;
+	}
+	cubes->setDirty(scene::EBT_VERTEX);
+}
+
+void BoardSceneNode::setCubeColor(int cell, video::SColor color) {
+	setInstanceColor(cell, color);
+}
+
+video::SColor BoardSceneNode::getCubeColor(int cell) const {
+	return states[cell];
+}
+
+void BoardSceneNode::setRaycubeColor(int entry, video::SColor color) {
+	setInstanceColor(boardSize*boardSize + entry, color);
+}
+
+video::SColor BoardSceneNode::getRaycubeColor(int entry) const {
+	return states[boardSize*boardSize + entry];
+}
+
+void BoardSceneNode::setAtomVisible(int cell, bool visible) {
+	if (atomVisible[cell] != visible) {
+		atomVisible[cell] = visible;
+		atomsDirty = true;
+		changed = true;
+	}
+}
+
+bool BoardSceneNode::isAtomVisible(int cell) const {
+	return atomVisible[cell];
+}
+
+void BoardSceneNode::rebuildAtoms() {
+	scene::IVertexBuffer& vertices = atoms->getVertexBuffer();
+	scene::IIndexBuffer& indices = atoms->getIndexBuffer();
+	vertices.set_used(0);
+	indices.set_used(0);
+	for (int cell = 0; cell < boardSize*boardSize; ++cell) {
+		if (atomVisible[cell]) {
+			const u32 first = vertices.size();
+			const core::vector3df position = getCubePosition(cell);
+			for (const video::S3DVertex& vertex : atomVertices) {
+				vertices.push_back(vertex);
+				vertices[vertices.size()-1].Pos += position;
+			}
+			for (u32 index : atomIndices) {
+				indices.push_back(first + index);
+			}
+		}
+	}
+	atoms->setDirty(scene::EBT_VERTEX_AND_INDEX);
+	atomsDirty = false;
+}
+
+void BoardSceneNode::OnRegisterSceneNode() {
+	if (IsVisible) {
+		SceneManager->registerNodeForRendering(this);
+	}
+	ISceneNode::OnRegisterSceneNode();
+}
+
+void BoardSceneNode::render() {
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+	driver->setTransform(video::ETS_WORLD, AbsoluteTransformation);
+	if (stateTexture && statesDirty) {
+		uploadStates();
+	}
+	driver->setMaterial(cubes->getMaterial());
+	driver->drawMeshBuffer(cubes);
+	if (atomsDirty) {
+		rebuildAtoms();
+	}
+	if (atoms->getIndexBuffer().size()) {
+		driver->setMaterial(atoms->getMaterial());
+		driver->drawMeshBuffer(atoms);
+	}
+}
+
+const core::aabbox3d<f32>& BoardSceneNode::getBoundingBox() const {
+	return box;
+}
+
+u32 BoardSceneNode::getMaterialCount() const {
+	return 2;
+}
+
+video::SMaterial& BoardSceneNode::getMaterial(u32 i) {
+	return i == 0 ? cubes->getMaterial() : atoms->getMaterial();
+}
@@ -0,0 +1,101 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BLACKBOX_BOARDNODE_H
+#define BLACKBOX_BOARDNODE_H
+
+#include <irrlicht.h>
+#include <vector>
+
+// draws the whole gameboard (cubes, raycubes and atoms) as one scene node
+// all cubes share one vertex buffer and all atoms another, so a frame takes two draw calls
+// no matter how large the board is; only visible atoms are in the buffer
+// on OpenGL the colours of the cubes are kept in a small state texture that a shader reads (one texel
+// per cube), so a reset or evaluation uploads a few kilobytes instead of the whole vertex buffer;
+// other drivers get the colours written into the vertices
+class BoardSceneNode : public irr::scene::ISceneNode {
+public:
+	// offset is the position of the lower left corner of the board
+	BoardSceneNode(irr::scene::ISceneNode* parent, irr::scene::ISceneManager* mgr, int size, float offset,
+		irr::scene::IMesh* cube, irr::scene::IMesh* atom,
+		irr::video::SColor cubeColor, irr::video::SColor raycubeColor, irr::video::SColor atomColor);
+	virtual ~BoardSceneNode();
+
+	int size() const {
+		return boardSize;
+	}
+
+	// gameboard cubes and atoms are addressed by their cell id (y*size+x), raycubes by their entry id
+	void setCubeColor(int cell, irr::video::SColor color);
+	irr::video::SColor getCubeColor(int cell) const;
+	void setRaycubeColor(int entry, irr::video::SColor color);
+	irr::video::SColor getRaycubeColor(int entry) const;
+	void setAtomVisible(int cell, bool visible);
+	bool isAtomVisible(int cell) const;
+
+	// whether the colours are read from the state texture by a shader
+	bool usesStateTexture() const {
+		return stateTexture != 0;
+	}
+
+	// whether a colour or atom changed since the last call (the board has to be drawn again)
+	bool takeChanged() {
+		bool was = changed;
+		changed = false;
+		return was;
+	}
+
+	// centre of a gameboard cube
+	irr::core::vector3df getCubePosition(int cell) const;
+	// centre of a raycube
+	irr::core::vector3df getRaycubePosition(int entry) const;
+
+	virtual void OnRegisterSceneNode();
+	virtual void render();
+	virtual const irr::core::aabbox3d<irr::f32>& getBoundingBox() const;
+	virtual irr::u32 getMaterialCount() const;
+	virtual irr::video::SMaterial& getMaterial(irr::u32 i);
+
+private:
+	// copy the mesh (rotated like the former single nodes) to the given position
+	void addInstance(irr::scene::CDynamicMeshBuffer* buffer, irr::scene::IMesh* mesh, const irr::core::vector3df& position, irr::video::SColor color);
+	void setInstanceColor(int instance, irr::video::SColor color);
+	void rebuildAtoms();
+	// set up the state texture and the shader, false if the driver cannot run it
+	bool createStateTexture();
+	void uploadStates();
+
+	int boardSize;
+	float boardOffset;
+	float cubeScale;
+	irr::scene::CDynamicMeshBuffer* cubes;
+	irr::scene::CDynamicMeshBuffer* atoms;
+	irr::u32 cubeVertices;
+	// a single atom at the origin
+	std::vector<irr::video::S3DVertex> atomVertices;
+	std::vector<irr::u32> atomIndices;
+	std::vector<bool> atomVisible;
+	bool atomsDirty;
+	// colour of every cube and raycube (in the order of the vertex buffer)
+	std::vector<irr::video::SColor> states;
+	irr::video::ITexture* stateTexture;
+	bool statesDirty;
+	bool changed;
+	irr::core::aabbox3df box;
+};
+
+#endif
@@ -0,0 +1,129 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "boardview.h"
+
+using namespace irr;
+
+// based on https://en.wikipedia.org/wiki/Web_colors
+std::vector<video::SColor> colors {
+	video::SColor(255, 128, 0, 128),	// Purple
+	video::SColor(255, 128, 0, 0),		// Maroon
+	video::SColor(255, 128, 128, 0),	// Olive
+	video::SColor(255, 0, 128, 128),	// Teal
+	video::SColor(255, 250, 128, 114),	// Salmon
+	video::SColor(255, 220, 20, 60),	// Crimson
+	video::SColor(255, 139, 0, 0),		// DarkRed
+	video::SColor(255, 255, 69, 0),		// OrangeRed
+	video::SColor(255, 255, 165, 0),	// Orange
+	video::SColor(255, 255, 215, 0),	// Gold
+	video::SColor(255, 0, 0, 255),		// Blue
+	video::SColor(255, 188, 143, 143),	// RosyBrown
+	video::SColor(255, 189, 183, 107),	// DarkKhaki
+	video::SColor(255, 0, 100, 0),		// DarkGreen
+	video::SColor(255, 210, 105, 30),	// Chocolate
+	video::SColor(255, 139, 69, 19),	// SaddleBrown
+	video::SColor(255, 85, 107, 47),	// DarkOliveGreen
+	video::SColor(255, 173, 255, 47),	// GreenYellow
+	video::SColor(255, 50, 205, 50),	// LimeGreen
+	video::SColor(255, 124, 252, 0),	// LawnGreen
+	video::SColor(255, 0, 255, 127),	// SpringGreen
+	video::SColor(255, 47, 79, 79),		// DarkSlateGray
+	video::SColor(255, 102, 205, 170),	// MediumAquamarine
+	video::SColor(255, 127, 255, 212),	// Aquamarine
+	video::SColor(255, 0, 206, 209),	// DarkTurquoise
+	video::SColor(255, 176, 224, 230),	// PowderBlue
+	video::SColor(255, 0, 191, 255),	// DeepSkyBlue
+	video::SColor(255, 100, 149, 237),	// CornflowerBlue
+	video::SColor(255, 238, 130, 238),	// Violet
+	video::SColor(255, 138, 43, 226),	// BlueViolet
+	video::SColor(255, 75, 0, 130),		// Indigo
+	video::SColor(255, 255, 192, 203),	// Pink
+	video::SColor(255, 255, 20, 147),	// DeepPink
+	video::SColor(255, 199, 21, 133)	// MediumVioletRed
+};
+
+const video::SColor cubeColor(255,0,0,128);//255,0,16,156);
+const video::SColor raycubeColor(255,0,0,0);//video::SColor(255,0,128,0);//255,0,156,5);
+const video::SColor atomColor(255,255,255,0);
+const video::SColor reflectedCube(255,255,255,255);
+const video::SColor foundColor(255,0,255,0);
+const video::SColor missedColor(255,255,0,0);
+const video::SColor hintColor(255,0,255,255);
+
+video::SColor rayColor(int ray) {
+	if (ray == Game::RAYCUBE_REFLECTED) {
+		return reflectedCube;
+	}
+	// the colors are used from the back, large boards can have more rays than colors, then the colors repeat
+	return colors[colors.size()-1 - ray%colors.size()];
+}
+
+void showGame(const Game& game, BoardSceneNode* boardNode, int hintEntry) {
+	for (int cell = 0; cell < game.size()*game.size(); ++cell) {
+		video::SColor color = cubeColor;
+		// after evaluation the hidden atoms are shown as found or missed
+		if (game.evaluated() && game.hasAtom(cell)) {
+			color = game.hasGuess(cell) ? foundColor : missedColor;
+		}
+		boardNode->setCubeColor(cell, color);
+		boardNode->setAtomVisible(cell, game.hasGuess(cell));
+	}
+	for (int entry = 0; entry < 4*game.size(); ++entry) {
+		int ray = game.raycube(entry);
+		if (ray == Game::RAYCUBE_UNUSED) {
+			boardNode->setRaycubeColor(entry, entry == hintEntry ? hintColor : raycubeColor);
+		} else {
+			boardNode->setRaycubeColor(entry, rayColor(ray));
+		}
+	}
+}
+
+void showGame(const Game& game, VolumeSceneNode* volumeNode) {
+	for (int cell = 0; cell < game.cells(); ++cell) {
+		video::SColor color = cubeColor;
+		if (game.evaluated() && game.hasAtom(cell)) {
+			color = game.hasGuess(cell) ? foundColor : missedColor;
+		}
+		volumeNode->setCubeColor(cell, color);
+		volumeNode->setAtomVisible(cell, game.hasGuess(cell));
+	}
+	for (int entry = 0; entry < game.entryCount(); ++entry) {
+		int ray = game.raycube(entry);
+		volumeNode->setRaycubeColor(entry, ray == Game::RAYCUBE_UNUSED ? raycubeColor : rayColor(ray));
+	}
+}
+
+void showSnapshot(const GameSnapshot& snapshot, BoardSceneNode* boardNode) {
+	for (int cell = 0; cell < static_cast<int>(snapshot.cells.size()); ++cell) {
+		const std::uint8_t flags = snapshot.cells[cell];
+		video::SColor color = cubeColor;
+		if (flags & GameSnapshot::CELL_ATOM) {
+			color = (flags & GameSnapshot::CELL_GUESS) ? foundColor : missedColor;
+		}
+		boardNode->setCubeColor(cell, color);
+		boardNode->setAtomVisible(cell, (flags & GameSnapshot::CELL_GUESS) != 0);
+	}
+	for (int entry = 0; entry < static_cast<int>(snapshot.raycubes.size()); ++entry) {
+		int ray = snapshot.raycubes[entry];
+		if (ray == Game::RAYCUBE_UNUSED) {
+			boardNode->setRaycubeColor(entry, entry == snapshot.hintEntry ? hintColor : raycubeColor);
+		} else {
+			boardNode->setRaycubeColor(entry, rayColor(ray));
+		}
+	}
+}
@@ -0,0 +1,63 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BLACKBOX_BOARDVIEW_H
+#define BLACKBOX_BOARDVIEW_H
+
+#include <irrlicht.h>
+#include "boardnode.h"
+#include "volumenode.h"
+#include "game.h"
+#include "gamethread.h"
+#include <algorithm>
+#include <vector>
+
+// the colors and the camera of the board, shared by the game and blackbox-render
+
+// the colors of the rays, shuffled once by the game
+extern std::vector<irr::video::SColor> colors;
+
+extern const irr::video::SColor cubeColor;
+extern const irr::video::SColor raycubeColor;
+extern const irr::video::SColor atomColor;
+extern const irr::video::SColor reflectedCube;
+extern const irr::video::SColor foundColor;
+extern const irr::video::SColor missedColor;
+extern const irr::video::SColor hintColor;
+
+// color of a raycube state that is no unused raycube
+irr::video::SColor rayColor(int ray);
+
+// show the state of the game on the board node (only changed colors mark the node as changed)
+// the raycube of the hint entry (if any) is highlighted
+void showGame(const Game& game, BoardSceneNode* boardNode, int hintEntry = -1);
+// the same for a game on a volume
+void showGame(const Game& game, VolumeSceneNode* volumeNode);
+// the same from a snapshot of the game thread (with its hint)
+void showSnapshot(const GameSnapshot& snapshot, BoardSceneNode* boardNode);
+
+// distance of the camera above the board (30 fits the 8x8 board)
+inline float cameraDistance(int size) {
+	return 30.0f * std::max(1.0f, (3*size + 10) / 34.0f);
+}
+
+// distance of the camera in front of a volume, which is three boards wide with the panels
+inline float volumeCameraDistance(int size) {
+	return 2.2f * cameraDistance(size);
+}
+
+#endif
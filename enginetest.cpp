@@ -0,0 +1,300 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "pcgrandom.h"
+#include "raytable.h"
+#include "solver.h"
+#include "volumeengine.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// checks the engine against the ray loop of the original game (ported below) and the solver
+// against counting all placements, run by ctest (blackbox-test) or by hand with -v
+
+namespace {
+
+bool verbose = false;
+int failures = 0;
+
+void check(bool ok, const char* what, int size, int detail) {
+	if (!ok) {
+		if (++failures <= 10) {
+			std::cerr << "FAIL " << what << " on size " << size << " (" << detail << ")" << std::endl;
+		}
+	}
+}
+
+// the ray logic of the original main loop on a grid of atoms (atom[x*size+y]), with the coloring of the
+// raycubes turned into outcomes
+RayResult baselineTrace(const std::vector<char>& atom, int size, int entry) {
+	auto atomAt = [&](int x, int y) {
+		return atom[x*size+y] != 0;
+	};
+	const int raycubeHit = entry / size;
+	const int index = entry % size;
+	bool horizontal = raycubeHit < 2;
+	int incrementor = raycubeHit == 0 || raycubeHit == 2 ? 1 : -1;
+	int x = 0;
+	int y = 0;
+	if (raycubeHit == 0) {
+		y = index;
+	} else if (raycubeHit == 1) {
+		x = size-1;
+		y = index;
+	} else if (raycubeHit == 2) {
+		x = index;
+	} else {
+		y = size-1;
+		x = index;
+	}
+
+	// if atom left or right of straight path: reflect
+	if ((horizontal && y < size-1 && atomAt(x, y+1)) || (horizontal && y > 0 && atomAt(x, y-1))
+	|| (!horizontal && x < size-1 && atomAt(x+1, y)) || (!horizontal && x > 0 && atomAt(x-1, y))) {
+		return RayResult(RAY_REFLECTION);
+	}
+	// a ray can not take more steps than there are cell sides to cross
+	for (int steps = 0; steps < 4*size*size + 4; ++steps) {
+		if (x >= size || x < 0 || y >= size || y < 0) {
+			int exit = x < 0 ? y : x >= size ? size + y : y < 0 ? 2*size + x : 3*size + x;
+			return exit == entry ? RayResult(RAY_REFLECTION) : RayResult(RAY_EXIT, exit);
+		}
+		if (atomAt(x, y)) {
+			return RayResult(RAY_HIT);
+		}
+		if (horizontal && y < size-1 && atomAt(x, y+1)) {
+			if (y > 0 && atomAt(x, y-1)) {
+				x -= incrementor;
+				incrementor *= -1;
+				continue;
+			}
+			horizontal = !horizontal;
+			x -= incrementor;
+			incrementor = -1;
+		}
+		if (horizontal && y > 0 && atomAt(x, y-1)) {
+			if (y < size-1 && atomAt(x, y+1)) {
+				x -= incrementor;
+				incrementor *= -1;
+				continue;
+			}
+			horizontal = !horizontal;
+			x -= incrementor;
+			incrementor = 1;
+		}
+		if (!horizontal && x < size-1 && atomAt(x+1, y)) {
+			if (x > 0 && atomAt(x-1, y)) {
+				y -= incrementor;
+				incrementor *= -1;
+				continue;
+			}
+			horizontal = !horizontal;
+			y -= incrementor;
+			incrementor = -1;
+		}
+		if (!horizontal && x > 0 && atomAt(x-1, y)) {
+			if (x < size-1 && atomAt(x+1, y)) {
+				y -= incrementor;
+				incrementor *= -1;
+				continue;
+			}
+			horizontal = !horizontal;
+			y -= incrementor;
+			incrementor = 1;
+		}
+		if (horizontal) {
+			x += incrementor;
+		} else {
+			y += incrementor;
+		}
+	}
+	// never ends: no outcome the engine can give
+	return RayResult(RAY_EXIT, -1);
+}
+
+// random boards of every size the bitboard holds against the original loop, through the engine and the table
+template <int Words>
+std::uint64_t checkEngine(Pcg32& rng, int minSize, int maxSize, int boards) {
+	std::uint64_t rays = 0;
+	std::vector<int> order;
+	std::vector<char> grid;
+	for (int size = minSize; size <= maxSize; ++size) {
+		resetCells(order, size*size);
+		for (int b = 0; b < boards; ++b) {
+			// from empty boards up to crowded ones
+			const int atoms = rng.below(std::min(size*size, 2*size + 2) + 1);
+			sampleCells(rng, order, atoms);
+			BasicBlackboxBoard<Words> board(size);
+			grid.assign(size*size, 0);
+			for (int i = 0; i < atoms; ++i) {
+				board.setAtom(order[i]);
+				grid[order[i]] = 1;
+			}
+			BasicRayEngine<Words> engine(board);
+			BasicRayTable<Words> table(board);
+			for (int entry = 0; entry < 4*size; ++entry) {
+				const RayResult expected = baselineTrace(grid, size, entry);
+				check(engine.trace(entry) == expected, "ray engine", size, entry);
+				check(table.outcome(entry) == expected, "ray table", size, entry);
+			}
+			rays += 4*size;
+		}
+	}
+	return rays;
+}
+
+// the solver counts the same placements as trying all of them against the original loop
+std::uint64_t checkSolver(Pcg32& rng, int size, int atoms, int puzzles) {
+	const int cells = size*size;
+	std::vector<int> order;
+	resetCells(order, cells);
+	std::vector<char> grid;
+	std::vector<Observation> observations;
+	std::vector<int> placement(atoms);
+	std::uint64_t placements = 0;
+	for (int p = 0; p < puzzles; ++p) {
+		sampleCells(rng, order, atoms);
+		grid.assign(cells, 0);
+		for (int i = 0; i < atoms; ++i) {
+			grid[order[i]] = 1;
+		}
+		// some of the rays, from none to all of them
+		observations.clear();
+		const int fired = rng.below(4*size + 1);
+		for (int entry = 0; entry < 4*size; ++entry) {
+			const RayResult result = baselineTrace(grid, size, entry);
+			check(result.outcome != RAY_EXIT || result.exit >= 0, "original loop ending", size, entry);
+			if (static_cast<int>(rng.below(4*size)) < fired && (result.outcome != RAY_EXIT || result.exit >= 0)) {
+				observations.push_back(Observation(entry, result));
+			}
+		}
+
+		// all placements in ascending cell order
+		std::uint64_t expected = 0;
+		for (int i = 0; i < atoms; ++i) {
+			placement[i] = i;
+		}
+		for (;;) {
+			grid.assign(cells, 0);
+			for (int cell : placement) {
+				grid[cell] = 1;
+			}
+			bool fits = true;
+			for (auto & observation : observations) {
+				if (baselineTrace(grid, size, observation.entry) != observation.result) {
+					fits = false;
+					break;
+				}
+			}
+			expected += fits;
+			++placements;
+			int i = atoms-1;
+			while (i >= 0 && placement[i] == cells - atoms + i) {
+				--i;
+			}
+			if (i < 0) {
+				break;
+			}
+			++placement[i];
+			for (int j = i+1; j < atoms; ++j) {
+				placement[j] = placement[j-1] + 1;
+			}
+		}
+
+		BasicSolver<1> solver(size, atoms, observations);
+		BasicSolver<1>::Result single = solver.solve(1);
+		BasicSolver<1>::Result parallel = solver.solve(4);
+		check(single.complete && single.count == expected, "solver count", size, static_cast<int>(expected));
+		check(parallel.complete && parallel.count == expected, "parallel solver count", size, static_cast<int>(expected));
+		check(solver.unique(1) == (expected == 1), "solver uniqueness", size, static_cast<int>(expected));
+	}
+	return placements;
+}
+
+// a volume whose atoms all lie on z = 0 traces the rays of that plane like the flat engine
+template <int Words>
+std::uint64_t checkVolume(Pcg32& rng, int minSize, int maxSize, int boards) {
+	std::uint64_t rays = 0;
+	std::vector<int> order;
+	for (int size = minSize; size <= maxSize; ++size) {
+		resetCells(order, size*size);
+		BasicVolumeRayEngine<Words> volume(size);
+		for (int b = 0; b < boards; ++b) {
+			const int atoms = rng.below(std::min(size*size, 2*size + 2) + 1);
+			sampleCells(rng, order, atoms);
+			BasicBlackboxBoard<64> board(size);
+			typename BasicVolumeRayEngine<Words>::Bits bits;
+			bits.clear();
+			for (int i = 0; i < atoms; ++i) {
+				board.setAtom(order[i]);
+				// the flat cell x*size+y is (x*size+y)*size+0 in the volume
+				bits.set(order[i]*size);
+			}
+			BasicRayEngine<64> flat(board);
+			volume.update(bits);
+			// the sides of the flat board are the first four faces, their index a*size+b has z = b = 0
+			for (int entry = 0; entry < 4*size; ++entry) {
+				const RayResult expected = flat.trace(entry);
+				RayResult result = volume.trace((entry/size)*size*size + (entry%size)*size);
+				if (result.outcome == RAY_EXIT) {
+					const int face = result.exit / (size*size);
+					const int index = result.exit % (size*size);
+					result.exit = face < 4 && index % size == 0 ? face*size + index/size : -1;
+				}
+				check(result == expected, "volume engine", size, entry);
+			}
+			rays += 4*size;
+		}
+	}
+	return rays;
+}
+
+}
+
+int main(int argc, char** argv) {
+	for (int i = 1; i < argc; ++i) {
+		if (!std::strcmp(argv[i], "-v")) {
+			verbose = true;
+		} else {
+			std::cerr << "usage: blackbox-test [-v]" << std::endl;
+			return 1;
+		}
+	}
+
+	Pcg32 rng(2018);
+	std::uint64_t rays = checkEngine<1>(rng, 1, 8, 8000);
+	rays += checkEngine<4>(rng, 9, 16, 1600);
+	rays += checkEngine<16>(rng, 17, 32, 240);
+	rays += checkEngine<64>(rng, 33, 64, 40);
+	std::uint64_t placements = checkSolver(rng, 4, 3, 300);
+	placements += checkSolver(rng, 4, 4, 100);
+	placements += checkSolver(rng, 5, 3, 100);
+	std::uint64_t volumeRays = checkVolume<1>(rng, 1, 4, 500);
+	volumeRays += checkVolume<8>(rng, 5, 8, 300);
+	volumeRays += checkVolume<64>(rng, 9, 16, 100);
+	if (verbose || failures) {
+		std::cerr << rays << " rays against the original loop, " << placements << " placements counted, "
+			<< volumeRays << " volume rays against the flat engine" << std::endl;
+	}
+	if (failures) {
+		std::cerr << failures << " checks failed" << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,70 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "framepacer.h"
+#include <thread>
+
+namespace {
+// keep drawing this long after input for gui effects that are not tied to events (tooltips)
+const std::chrono::milliseconds settleTime(1500);
+// draw at least this often, the window may have been covered
+const std::chrono::seconds refreshTime(1);
+// poll interval for input when idle
+const std::chrono::milliseconds idlePoll(10);
+}
+
+FramePacer::FramePacer(int maxFps, bool onDemand): onDemand(onDemand), dirty(true) {
+	if (maxFps > 0) {
+		frameInterval = std::chrono::duration_cast<Clock::duration>(std::chrono::seconds(1)) / maxFps;
+	} else {
+		frameInterval = Clock::duration::zero();
+	}
+	lastInput = Clock::now();
+	lastFrame = lastInput;
+	nextFrame = lastInput;
+}
+
+void FramePacer::input() {
+	dirty = true;
+	lastInput = Clock::now();
+}
+
+bool FramePacer::shouldDraw() const {
+	if (!onDemand || dirty) {
+		return true;
+	}
+	Clock::time_point now = Clock::now();
+	return now - lastInput < settleTime || now - lastFrame >= refreshTime;
+}
+
+void FramePacer::frameDrawn() {
+	dirty = false;
+	lastFrame = Clock::now();
+	// frames are spaced by their start, a late frame does not make the next ones hurry
+	nextFrame += frameInterval;
+	if (nextFrame < lastFrame) {
+		nextFrame = lastFrame;
+	}
+}
+
+void FramePacer::wait(bool drawn) const {
+	if (drawn) {
+		std::this_thread::sleep_until(nextFrame);
+	} else {
+		std::this_thread::sleep_for(idlePoll);
+	}
+}
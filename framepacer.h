@@ -0,0 +1,56 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BLACKBOX_FRAMEPACER_H
+#define BLACKBOX_FRAMEPACER_H
+
+#include <chrono>
+
+// decides when the main loop has to draw and sleeps in between
+// in on demand mode a frame is only drawn if something changed, shortly after input (so gui hover
+// effects and tooltips can appear) and once per second (to repaint a window that was covered)
+class FramePacer {
+public:
+	typedef std::chrono::steady_clock Clock;
+
+	// maxFps = 0 does not limit the frame rate
+	FramePacer(int maxFps, bool onDemand);
+
+	// the scene or gui changed and has to be drawn again
+	void invalidate() {
+		dirty = true;
+	}
+
+	// an input event arrived
+	void input();
+
+	bool shouldDraw() const;
+	void frameDrawn();
+
+	// sleep until the next frame may be drawn (or, when idle, until input should be polled again)
+	void wait(bool drawn) const;
+
+private:
+	Clock::duration frameInterval;
+	bool onDemand;
+	bool dirty;
+	Clock::time_point lastInput;
+	Clock::time_point lastFrame;
+	Clock::time_point nextFrame;
+};
+
+#endif
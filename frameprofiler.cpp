@@ -0,0 +1,122 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "frameprofiler.h"
+#include <algorithm>
+
+namespace {
+// number of recent frames the percentiles are taken from
+const std::size_t frameWindow = 256;
+// number of recent input events the latency percentiles are taken from
+const std::size_t latencyWindow = 64;
+// number of events written at once
+const std::size_t eventBlock = 4096;
+
+const char* const phaseNames[] = {"input", "pick", "snapshot", "text", "scene", "gui", "endScene"};
+
+// event kinds after the phases and the frame (PHASE_COUNT)
+const int latencyEvent = PHASE_COUNT+1;
+}
+
+FrameProfiler::FrameProfiler(): origin(Clock::now()), frameStart(origin), frameTimes(frameWindow), latencies(latencyWindow), sorted(frameWindow), trace(0), firstEvent(true) {
+	pendingInputs.reserve(latencyWindow);
+}
+
+FrameProfiler::~FrameProfiler() {
+	if (trace) {
+		flush();
+		std::fputs("\n]\n", trace);
+		std::fclose(trace);
+	}
+}
+
+bool FrameProfiler::openTrace(const std::string& fileName) {
+	trace = std::fopen(fileName.c_str(), "w");
+	if (!trace) {
+		return false;
+	}
+	events.reserve(eventBlock);
+	std::fputs("[\n", trace);
+	return true;
+}
+
+void FrameProfiler::frameDrawn() {
+	Clock::time_point end = Clock::now();
+	frameTimes.add(std::chrono::duration<double, std::milli>(end - frameStart).count());
+	if (trace) {
+		addEvent(PHASE_COUNT, frameStart, end);
+	}
+	for (auto arrived : pendingInputs) {
+		latencies.add(std::chrono::duration<double, std::milli>(end - arrived).count());
+		if (trace) {
+			addEvent(latencyEvent, arrived, end);
+		}
+	}
+	pendingInputs.clear();
+}
+
+void FrameProfiler::inputHandled(Clock::time_point arrived) {
+	// more events than fit between two frames only happen if nothing is drawn, the oldest are enough then
+	if (pendingInputs.size() < pendingInputs.capacity()) {
+		pendingInputs.push_back(arrived);
+	}
+}
+
+double FrameProfiler::percentile(double fraction) const {
+	return percentile(frameTimes, fraction);
+}
+
+double FrameProfiler::latencyPercentile(double fraction) const {
+	return percentile(latencies, fraction);
+}
+
+double FrameProfiler::percentile(const Window& window, double fraction) const {
+	std::size_t count = std::min(window.count, window.values.size());
+	if (count == 0) {
+		return 0.0;
+	}
+	std::copy(window.values.begin(), window.values.begin()+count, sorted.begin());
+	std::size_t rank = std::min(count-1, static_cast<std::size_t>(fraction*count));
+	std::nth_element(sorted.begin(), sorted.begin()+rank, sorted.begin()+count);
+	return sorted[rank];
+}
+
+const char* FrameProfiler::phaseName(FramePhase phase) {
+	if (phase < PHASE_COUNT) {
+		return phaseNames[phase];
+	}
+	return phase == PHASE_COUNT ? "frame" : "input latency";
+}
+
+void FrameProfiler::addEvent(int phase, Clock::time_point start, Clock::time_point end) {
+	events.push_back(Event{phase, start, end});
+	if (events.size() >= eventBlock) {
+		flush();
+	}
+}
+
+void FrameProfiler::flush() {
+	// complete events with timestamps in microseconds, frames and input latencies on tracks of their own
+	for (auto & event : events) {
+		double ts = std::chrono::duration<double, std::micro>(event.start - origin).count();
+		double dur = std::chrono::duration<double, std::micro>(event.end - event.start).count();
+		std::fprintf(trace, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+			firstEvent ? "" : ",\n", phaseName(static_cast<FramePhase>(event.phase)), event.phase == PHASE_COUNT ? 1 : event.phase == latencyEvent ? 3 : 2, ts, dur);
+		firstEvent = false;
+	}
+	events.clear();
+}
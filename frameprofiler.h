@@ -0,0 +1,128 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BLACKBOX_FRAMEPROFILER_H
+#define BLACKBOX_FRAMEPROFILER_H
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// the phases of the main loop that are timed
+enum FramePhase {
+	PHASE_INPUT = 0,
+	PHASE_PICK,
+	PHASE_SNAPSHOT,
+	PHASE_TEXT,
+	PHASE_SCENE,
+	PHASE_GUI,
+	PHASE_END_SCENE,
+	PHASE_COUNT
+};
+
+// times the phases of the main loop and the drawn frames
+// a phase costs two clock reads, frame times are kept for the last frames to get percentiles
+// and every timing can be written to a chrome trace (chrome://tracing or perfetto)
+// the same is done for the latency of input events, from their arrival to the end of the frame showing them
+class FrameProfiler {
+public:
+	typedef std::chrono::steady_clock Clock;
+
+	// times a phase from construction to destruction
+	class Scope {
+	public:
+		Scope(FrameProfiler& profiler, FramePhase phase): profiler(profiler), phase(phase), start(Clock::now()) {}
+		~Scope() {
+			profiler.record(phase, start, Clock::now());
+		}
+
+	private:
+		FrameProfiler& profiler;
+		FramePhase phase;
+		Clock::time_point start;
+	};
+
+	FrameProfiler();
+	~FrameProfiler();
+
+	// write all timings to a chrome trace file, returns false if it cannot be opened
+	bool openTrace(const std::string& fileName);
+
+	// a loop iteration starts (frame time is measured from here to frameDrawn)
+	void beginFrame() {
+		frameStart = Clock::now();
+	}
+
+	void frameDrawn();
+
+	// an input event that arrived at the given time was handled, its latency ends with the next drawn frame
+	void inputHandled(Clock::time_point arrived);
+
+	void record(FramePhase phase, Clock::time_point start, Clock::time_point end) {
+		if (trace) {
+			addEvent(phase, start, end);
+		}
+	}
+
+	// frame time in milliseconds that the given fraction of the recent frames stayed below
+	double percentile(double fraction) const;
+
+	// the same for the latency of the recent input events
+	double latencyPercentile(double fraction) const;
+
+	static const char* phaseName(FramePhase phase);
+
+private:
+	// a phase or frame (PHASE_COUNT) to write
+	struct Event {
+		int phase;
+		Clock::time_point start;
+		Clock::time_point end;
+	};
+
+	// recent values in a ring
+	struct Window {
+		std::vector<double> values;
+		std::size_t next;
+		std::size_t count;
+		explicit Window(std::size_t size): values(size, 0.0), next(0), count(0) {}
+		void add(double value) {
+			values[next] = value;
+			next = (next+1) % values.size();
+			++count;
+		}
+	};
+
+	void addEvent(int phase, Clock::time_point start, Clock::time_point end);
+	void flush();
+	double percentile(const Window& window, double fraction) const;
+
+	Clock::time_point origin;
+	Clock::time_point frameStart;
+	Window frameTimes;
+	Window latencies;
+	mutable std::vector<double> sorted;
+	// arrival of the input events handled since the last drawn frame
+	std::vector<Clock::time_point> pendingInputs;
+	// events are buffered and written in blocks
+	std::FILE* trace;
+	std::vector<Event> events;
+	bool firstEvent;
+};
+
+#endif
@@ -0,0 +1,223 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "game.h"
+#include <stdexcept>
+#include <utility>
+
+Game::Game(int size, int atoms, std::uint64_t seed, std::uint64_t stream): Game(createGameBoard(size), atoms, seed, stream) {
+}
+
+Game::Game(std::unique_ptr<GameBoard> gameBoard, int atoms, std::uint64_t seed, std::uint64_t stream): board(std::move(gameBoard)), rng(seed, stream), maxAtoms(atoms), nextMaxAtoms(atoms), log(0), loggedHeader(0) {
+	if (!board) {
+		throw std::invalid_argument("unsupported board size");
+	}
+	if (atoms < 0 || atoms > board->cells()) {
+		throw std::invalid_argument("atom count does not fit the board");
+	}
+	resetCells(cellOrder, board->cells());
+	reset();
+}
+
+void Game::clearState() {
+	points = 0;
+	placed = 0;
+	fired.clear();
+	// a game has at most one ray per raycube, so firing never allocates
+	fired.reserve(board->entryCount());
+	colored = 0;
+	wasEvaluated = false;
+	guesses.assign(board->cells(), 0);
+	raycubes.assign(board->entryCount(), RAYCUBE_UNUSED);
+}
+
+void Game::reset() {
+	maxAtoms = nextMaxAtoms;
+	clearState();
+	// get random positions for atoms (defines their placement), drawn without rejection
+	board->clear();
+	sampleCells(rng, cellOrder, maxAtoms);
+	for (int i = 0; i < maxAtoms; ++i) {
+		board->setAtom(cellOrder[i]);
+	}
+	logGame();
+}
+
+void Game::reset(const std::vector<int>& atoms) {
+	clearState();
+	board->clear();
+	for (int cell : atoms) {
+		if (cell < 0 || cell >= board->cells()) {
+			throw std::invalid_argument("atom outside of the board");
+		}
+		board->setAtom(cell);
+	}
+	maxAtoms = board->atomCount();
+	nextMaxAtoms = maxAtoms;
+	logGame();
+}
+
+bool Game::fire(int entry, RayResult* result) {
+	if (entry < 0 || entry >= board->entryCount() || raycubes[entry] != RAYCUBE_UNUSED) {
+		return false;
+	}
+	// each raycube clicked costs a point
+	++points;
+	const RayResult& outcome = board->outcome(entry);
+	fired.push_back(Observation(entry, outcome));
+	if (log) {
+		logEvent(LOG_RAY, entry);
+		logValue(encodeLogResult(outcome));
+	}
+	if (outcome.outcome == RAY_REFLECTION) {
+		raycubes[entry] = RAYCUBE_REFLECTED;
+	} else {
+		// color the raycube (and the one the ray left through) with the number of the ray
+		raycubes[entry] = colored;
+		if (outcome.outcome == RAY_EXIT) {
+			raycubes[outcome.exit] = colored;
+		}
+		++colored;
+	}
+	if (result) {
+		*result = outcome;
+	}
+	return true;
+}
+
+bool Game::placeAtom(int cell) {
+	if (cell < 0 || cell >= board->cells() || guesses[cell] || placed >= maxAtoms) {
+		return false;
+	}
+	guesses[cell] = 1;
+	++placed;
+	if (log) {
+		logEvent(LOG_PLACE, cell);
+	}
+	return true;
+}
+
+bool Game::removeAtom(int cell) {
+	if (cell < 0 || cell >= board->cells() || !guesses[cell]) {
+		return false;
+	}
+	guesses[cell] = 0;
+	--placed;
+	if (log) {
+		logEvent(LOG_REMOVE, cell);
+	}
+	return true;
+}
+
+void Game::evaluate() {
+	// walks the cells instead of atomPositions, so evaluating does not allocate
+	const int cells = board->cells();
+	for (int cell = 0; cell < cells; ++cell) {
+		if (board->hasAtom(cell) && !guesses[cell]) {
+			points += 5;
+		}
+	}
+	wasEvaluated = true;
+	if (log) {
+		logEvent(LOG_EVALUATE, points);
+	}
+}
+
+void Game::record(GameLogWriter* writer) {
+	flushLog();
+	log = writer;
+	if (log) {
+		// room for the events of a usual game, so recording does not allocate in the frame loop
+		logged.reserve(4096);
+		logGame();
+	}
+}
+
+void Game::flushLog() {
+	if (log && logged.size() > loggedHeader) {
+		log->write(logged.data(), logged.size());
+	}
+	logged.clear();
+	loggedHeader = 0;
+}
+
+void Game::logGame() {
+	if (!log) {
+		return;
+	}
+	flushLog();
+	logEvent(LOG_GAME, board->atomCount());
+	const int cells = board->cells();
+	for (int cell = 0; cell < cells; ++cell) {
+		if (board->hasAtom(cell)) {
+			logValue(cell);
+		}
+	}
+	loggedHeader = logged.size();
+}
+
+void Game::logEvent(GameLogEventType type, int value) {
+	logged.push_back(type);
+	logValue(value);
+}
+
+void Game::logValue(int value) {
+	std::uint16_t word = value;
+	const std::uint8_t* bytes = reinterpret_cast<const std::uint8_t*>(&word);
+	logged.insert(logged.end(), bytes, bytes+2);
+}
+
+bool Game::moreAtoms() {
+	if (nextMaxAtoms >= board->size()*2 || nextMaxAtoms >= board->cells()) {
+		return false;
+	}
+	++nextMaxAtoms;
+	return true;
+}
+
+bool Game::fewerAtoms() {
+	if (nextMaxAtoms <= minAtoms) {
+		return false;
+	}
+	--nextMaxAtoms;
+	return true;
+}
+
+int Game::atomsFound() const {
+	int found = 0;
+	const int cells = board->cells();
+	for (int cell = 0; cell < cells; ++cell) {
+		if (board->hasAtom(cell)) {
+			found += guesses[cell];
+		}
+	}
+	return found;
+}
+
+const char* Game::rating() const {
+	const int size = board->size();
+	if (points == size) {
+		return "Perfect!";
+	} else if (points < size*2) {
+		return "Well done!";
+	} else if (points > size*4) {
+		return "Better luck next time!";
+	} else if (points > size*3) {
+		return "Getting there!";
+	}
+	return "Nice!";
+}
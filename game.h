@@ -0,0 +1,177 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BLACKBOX_GAME_H
+#define BLACKBOX_GAME_H
+
+#include "gameboard.h"
+#include "gamelog.h"
+#include "pcgrandom.h"
+#include "solver.h"
+#include <memory>
+#include <vector>
+
+// the rules and scoring of a game, without any rendering
+// every ray costs a point and every atom that was not found costs five points on evaluation
+class Game {
+public:
+	// raycube states (colored raycubes hold the number of the ray instead, starting at 0)
+	enum {
+		RAYCUBE_UNUSED = -1,
+		RAYCUBE_REFLECTED = -2
+	};
+
+	// the fewest atoms a game can be set to (the most are twice the board size)
+	static const int minAtoms = 3;
+	// the atoms of the first game in the window (on every board)
+	static const int defaultAtoms = 5;
+
+	// starts a game with random atoms drawn from a stream of the seed
+	Game(int size, int atoms, std::uint64_t seed, std::uint64_t stream = 0);
+	// the same on a given board (e.g. a volume from createVolumeBoard)
+	Game(std::unique_ptr<GameBoard> board, int atoms, std::uint64_t seed, std::uint64_t stream = 0);
+
+	// restart the random atoms of the following games (the same seed always gives the same games)
+	void seed(std::uint64_t seed, std::uint64_t stream = 0) {
+		rng.seed(seed, stream);
+		resetCells(cellOrder, board->cells());
+	}
+
+	// start a new game with random atoms (the number of atoms set by more/fewerAtoms)
+	void reset();
+	// start a new game with the given atoms
+	void reset(const std::vector<int>& atoms);
+
+	// shoot a ray from an unused raycube, returns false if the raycube was used already
+	bool fire(int entry, RayResult* result = 0);
+	// place or remove a guessed atom, returns false if nothing changed
+	bool placeAtom(int cell);
+	bool removeAtom(int cell);
+	// add the penalty for all atoms that were not found
+	void evaluate();
+
+	// record this game and the following ones into a log (null stops recording)
+	// the events of a game are written once the next one starts, or on flushLog
+	// (a game nothing happened in is left out, e.g. the one a client never played before its first new game)
+	void record(GameLogWriter* writer);
+	// write the events of the current game now (the following events start a new game in the log)
+	void flushLog();
+
+	// change the number of atoms of the next game, returns false at the limits
+	bool moreAtoms();
+	bool fewerAtoms();
+
+	int size() const {
+		return board->size();
+	}
+
+	// number of cells and raycubes (size*size and 4*size on the flat board)
+	int cells() const {
+		return board->cells();
+	}
+
+	int entryCount() const {
+		return board->entryCount();
+	}
+
+	int penalty() const {
+		return points;
+	}
+
+	int atoms() const {
+		return maxAtoms;
+	}
+
+	int nextAtoms() const {
+		return nextMaxAtoms;
+	}
+
+	// whether the number of atoms for the next game differs from the current one
+	bool atomsChanged() const {
+		return nextMaxAtoms != maxAtoms;
+	}
+
+	int atomsSet() const {
+		return placed;
+	}
+
+	bool evaluated() const {
+		return wasEvaluated;
+	}
+
+	bool hasGuess(int cell) const {
+		return guesses[cell] != 0;
+	}
+
+	bool hasAtom(int cell) const {
+		return board->hasAtom(cell);
+	}
+
+	// RAYCUBE_UNUSED, RAYCUBE_REFLECTED or the number of the ray that colored the raycube
+	int raycube(int entry) const {
+		return raycubes[entry];
+	}
+
+	// all rays fired in this game in the order they were fired
+	const std::vector<Observation>& rays() const {
+		return fired;
+	}
+
+	// corners of the path of a fired ray (see BasicRayEngine::tracePath)
+	void rayPath(int entry, std::vector<RayPoint>& corners) const {
+		board->path(entry, corners);
+	}
+
+	// number of atoms that were guessed correctly
+	int atomsFound() const;
+
+	// cell ids of the hidden atoms
+	std::vector<int> atomPositions() const {
+		return board->atomPositions();
+	}
+
+	// a word on the penalty after evaluation
+	const char* rating() const;
+
+private:
+	void clearState();
+	// start a new game in the log with the current atoms
+	void logGame();
+	void logEvent(GameLogEventType type, int value);
+	void logValue(int value);
+
+	std::unique_ptr<GameBoard> board;
+	Pcg32 rng;
+	// the cells shuffled by the atom placement so far (see sampleCells)
+	std::vector<int> cellOrder;
+	int maxAtoms;
+	int nextMaxAtoms;
+	int points;
+	int placed;
+	int colored;
+	bool wasEvaluated;
+	std::vector<char> guesses;
+	std::vector<int> raycubes;
+	std::vector<Observation> fired;
+	GameLogWriter* log;
+	// events of the current game not yet handed to the log
+	std::vector<std::uint8_t> logged;
+	// length of the LOG_GAME event that starts logged, a game without further events is not written
+	std::size_t loggedHeader;
+};
+
+#endif
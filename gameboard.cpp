@@ -0,0 +1,183 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "gameboard.h"
+#include "raytable.h"
+#include <algorithm>
+
+namespace {
+
+template <int Words>
+class BasicGameBoard : public GameBoard {
+public:
+	explicit BasicGameBoard(int size): board(size), rays(board), stale(false) {}
+
+	int size() const {
+		return board.size();
+	}
+
+	bool hasAtom(int cell) const {
+		return board.hasAtom(cell);
+	}
+
+	void setAtom(int cell) {
+		board.setAtom(cell);
+		stale = true;
+	}
+
+	void removeAtom(int cell) {
+		board.removeAtom(cell);
+		stale = true;
+	}
+
+	void clear() {
+		board.clear();
+		stale = true;
+	}
+
+	int atomCount() const {
+		return board.atomCount();
+	}
+
+	std::vector<int> atomPositions() const {
+		return board.atomPositions();
+	}
+
+	const RayResult& outcome(int entry) {
+		if (stale) {
+			rays.reset(board);
+			stale = false;
+		}
+		return rays.outcome(entry);
+	}
+
+	void path(int entry, std::vector<RayPoint>& corners) {
+		if (stale) {
+			rays.reset(board);
+			stale = false;
+		}
+		rays.path(entry, corners);
+	}
+
+private:
+	BasicBlackboxBoard<Words> board;
+	BasicRayTable<Words> rays;
+	bool stale;
+};
+
+template <int Words>
+class BasicVolumeBoard : public GameBoard {
+public:
+	explicit BasicVolumeBoard(int size): engine(size), outcomes(engine.entryCount()), known(engine.entryCount(), 0), stale(false) {}
+
+	int size() const {
+		return engine.size();
+	}
+
+	int cells() const {
+		return engine.cells();
+	}
+
+	int entryCount() const {
+		return engine.entryCount();
+	}
+
+	bool hasAtom(int cell) const {
+		return atomBits.test(cell);
+	}
+
+	void setAtom(int cell) {
+		atomBits.set(cell);
+		stale = true;
+	}
+
+	void removeAtom(int cell) {
+		atomBits.reset(cell);
+		stale = true;
+	}
+
+	void clear() {
+		atomBits.clear();
+		stale = true;
+	}
+
+	int atomCount() const {
+		return atomBits.count();
+	}
+
+	std::vector<int> atomPositions() const {
+		std::vector<int> positions;
+		atomBits.forEach([&](int cell) { positions.push_back(cell); });
+		return positions;
+	}
+
+	// traced on the first query like in a RayTable
+	const RayResult& outcome(int entry) {
+		if (stale) {
+			engine.update(atomBits);
+			std::fill(known.begin(), known.end(), 0);
+			stale = false;
+		}
+		if (!known[entry]) {
+			outcomes[entry] = engine.trace(entry);
+			known[entry] = 1;
+		}
+		return outcomes[entry];
+	}
+
+	void path(int /*entry*/, std::vector<RayPoint>& corners) {
+		corners.clear();
+	}
+
+private:
+	BasicVolumeRayEngine<Words> engine;
+	Bitboard<Words> atomBits;
+	std::vector<RayResult> outcomes;
+	std::vector<char> known;
+	bool stale;
+};
+
+}
+
+std::unique_ptr<GameBoard> createGameBoard(int size) {
+	if (size < 1 || size > maxBoardSize) {
+		return std::unique_ptr<GameBoard>();
+	}
+	if (size <= 8) {
+		return std::unique_ptr<GameBoard>(new BasicGameBoard<1>(size));
+	}
+	if (size <= 16) {
+		return std::unique_ptr<GameBoard>(new BasicGameBoard<4>(size));
+	}
+	if (size <= 32) {
+		return std::unique_ptr<GameBoard>(new BasicGameBoard<16>(size));
+	}
+	return std::unique_ptr<GameBoard>(new BasicGameBoard<64>(size));
+}
+
+std::unique_ptr<GameBoard> createVolumeBoard(int size) {
+	if (size < 1 || size > maxVolumeSize) {
+		return std::unique_ptr<GameBoard>();
+	}
+	if (size <= 4) {
+		return std::unique_ptr<GameBoard>(new BasicVolumeBoard<1>(size));
+	}
+	if (size <= 8) {
+		return std::unique_ptr<GameBoard>(new BasicVolumeBoard<8>(size));
+	}
+	return std::unique_ptr<GameBoard>(new BasicVolumeBoard<64>(size));
+}
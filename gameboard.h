@@ -0,0 +1,65 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BLACKBOX_GAMEBOARD_H
+#define BLACKBOX_GAMEBOARD_H
+
+#include "rayengine.h"
+#include "volumeengine.h"
+#include <memory>
+#include <vector>
+
+// largest supported board (64 words of atoms)
+const int maxBoardSize = 64;
+
+// a board whose size is only known at runtime
+// createGameBoard picks the smallest specialised bitboard (1, 4, 16 or 64 words) for the size,
+// so the default board still runs on a single word; createVolumeBoard does the same for a cube of cells
+class GameBoard {
+public:
+	virtual ~GameBoard() {}
+
+	virtual int size() const = 0;
+	virtual bool hasAtom(int cell) const = 0;
+	virtual void setAtom(int cell) = 0;
+	virtual void removeAtom(int cell) = 0;
+	virtual void clear() = 0;
+	virtual int atomCount() const = 0;
+	// cell ids of all atoms in ascending order
+	virtual std::vector<int> atomPositions() const = 0;
+
+	// outcome of a ray, each entry is traced once until the atoms change
+	virtual const RayResult& outcome(int entry) = 0;
+	// corners of the path of a ray (see BasicRayEngine::tracePath)
+	virtual void path(int entry, std::vector<RayPoint>& corners) = 0;
+
+	virtual int cells() const {
+		return size()*size();
+	}
+
+	virtual int entryCount() const {
+		return 4*size();
+	}
+};
+
+// returns null for sizes outside of 1..maxBoardSize
+std::unique_ptr<GameBoard> createGameBoard(int size);
+// a size*size*size volume with six faces of raycubes (see BasicVolumeRayEngine), it has no ray paths
+// returns null for sizes outside of 1..maxVolumeSize
+std::unique_ptr<GameBoard> createVolumeBoard(int size);
+
+#endif
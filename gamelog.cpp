@@ -0,0 +1,182 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "gamelog.h"
+#include "game.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+bool GameLogWriter::open(const std::string& path, int size) {
+	close();
+	std::memcpy(header.magic, "BBLG", 4);
+	header.version = gameLogVersion;
+	header.size = size;
+	header.reserved = 0;
+	ok = true;
+	if (path == "-") {
+		file = stdout;
+		return std::fwrite(&header, sizeof(header), 1, file) == 1;
+	}
+	// an existing log is continued if it was written for the same board size
+	if (std::FILE* existing = std::fopen(path.c_str(), "rb")) {
+		GameLogHeader old;
+		bool empty = std::fread(&old, sizeof(old), 1, existing) != 1;
+		std::fclose(existing);
+		if (!empty && (std::memcmp(old.magic, header.magic, 4) != 0 || old.version != header.version || old.size != header.size)) {
+			return false;
+		}
+	}
+	file = std::fopen(path.c_str(), "ab");
+	if (!file) {
+		return false;
+	}
+	if (std::ftell(file) == 0) {
+		return std::fwrite(&header, sizeof(header), 1, file) == 1;
+	}
+	return true;
+}
+
+bool GameLogWriter::write(const std::uint8_t* events, std::size_t length) {
+	ok = ok && file && std::fwrite(events, 1, length, file) == length;
+	return ok;
+}
+
+bool GameLogWriter::close() {
+	if (!file) {
+		return true;
+	}
+	bool closed = file == stdout ? std::fflush(file) == 0 : std::fclose(file) == 0;
+	file = 0;
+	return closed && ok;
+}
+
+bool GameLogReader::open(const std::string& path) {
+	close();
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(GameLogHeader))) {
+		::close(fd);
+		return false;
+	}
+	void* mapped = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (mapped == MAP_FAILED) {
+		return false;
+	}
+	// the events are read once from front to back
+	madvise(mapped, st.st_size, MADV_SEQUENTIAL);
+	data = static_cast<const std::uint8_t*>(mapped);
+	length = st.st_size;
+	const GameLogHeader* header = reinterpret_cast<const GameLogHeader*>(data);
+	if (std::memcmp(header->magic, "BBLG", 4) != 0 || header->version != gameLogVersion || header->size == 0) {
+		close();
+		return false;
+	}
+	position = sizeof(GameLogHeader);
+	return true;
+}
+
+void GameLogReader::close() {
+	if (data) {
+		munmap(const_cast<std::uint8_t*>(data), length);
+	}
+	data = 0;
+	length = 0;
+	position = 0;
+	broken = false;
+}
+
+bool GameLogReader::read(std::uint16_t& value) {
+	if (length - position < 2) {
+		broken = true;
+		return false;
+	}
+	std::memcpy(&value, data + position, 2);
+	position += 2;
+	return true;
+}
+
+bool GameLogReader::next(GameLogEvent& event) {
+	if (position >= length || broken) {
+		return false;
+	}
+	event.type = static_cast<GameLogEventType>(data[position++]);
+	std::uint16_t value;
+	if (!read(value)) {
+		return false;
+	}
+	event.value = value;
+	event.cells = 0;
+	switch (event.type) {
+		case LOG_GAME:
+			if (length - position < 2u*value) {
+				broken = true;
+				return false;
+			}
+			event.cells = data + position;
+			position += 2u*value;
+			return true;
+		case LOG_RAY:
+			if (!read(value)) {
+				return false;
+			}
+			event.result = decodeLogResult(value);
+			return true;
+		case LOG_PLACE:
+		case LOG_REMOVE:
+		case LOG_EVALUATE:
+			return true;
+		default:
+			broken = true;
+			return false;
+	}
+}
+
+GameLogReplay::GameLogReplay(Game& game): game(game) {
+}
+
+bool GameLogReplay::play(const GameLogEvent& event) {
+	switch (event.type) {
+		case LOG_GAME:
+			atoms.clear();
+			for (int i = 0; i < event.value; ++i) {
+				if (event.atom(i) >= game.size()*game.size()) {
+					return false;
+				}
+				atoms.push_back(event.atom(i));
+			}
+			game.reset(atoms);
+			return true;
+		case LOG_RAY: {
+			RayResult result;
+			return game.fire(event.value, &result) && result == event.result;
+		}
+		case LOG_PLACE:
+			return game.placeAtom(event.value);
+		case LOG_REMOVE:
+			return game.removeAtom(event.value);
+		case LOG_EVALUATE:
+			game.evaluate();
+			return game.penalty() == event.value;
+	}
+	return false;
+}
@@ -0,0 +1,159 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BLACKBOX_GAMELOG_H
+#define BLACKBOX_GAMELOG_H
+
+#include "rayengine.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+class Game;
+
+// a game log is a header followed by the events of the games in the order they happened
+// every event is a type byte followed by 16 bit values (host byte order, not aligned):
+//   LOG_GAME       atoms, cell...   a new game with its hidden atoms
+//   LOG_RAY        entry, outcome   a ray and its outcome code (see encodeLogResult)
+//   LOG_PLACE      cell             a guessed atom was placed
+//   LOG_REMOVE     cell             a guessed atom was removed
+//   LOG_EVALUATE   penalty          the penalty after evaluation
+// a game ends where the next one starts, so a log can only be appended to
+struct GameLogHeader {
+	char magic[4];			// "BBLG"
+	std::uint16_t version;
+	std::uint8_t size;
+	std::uint8_t reserved;
+};
+
+const std::uint16_t gameLogVersion = 1;
+
+enum GameLogEventType {
+	LOG_GAME = 1,
+	LOG_RAY,
+	LOG_PLACE,
+	LOG_REMOVE,
+	LOG_EVALUATE
+};
+
+// like encodeResult of the puzzle files, but the exits of boards larger than 63 need 16 bits
+inline std::uint16_t encodeLogResult(const RayResult& result) {
+	return result.outcome == RAY_EXIT ? 2 + result.exit : (result.outcome == RAY_HIT ? 0 : 1);
+}
+
+inline RayResult decodeLogResult(std::uint16_t code) {
+	if (code == 0) {
+		return RayResult(RAY_HIT);
+	}
+	if (code == 1) {
+		return RayResult(RAY_REFLECTION);
+	}
+	return RayResult(RAY_EXIT, code - 2);
+}
+
+// appends the events of finished games to a log file (one writer per thread)
+// Game::record collects the events of a game and hands them over once the game ends,
+// so the games of many connections can share one writer without interleaving
+class GameLogWriter {
+public:
+	GameLogWriter(): file(0), header(), ok(false) {}
+	~GameLogWriter() {
+		close();
+	}
+	// appends to an existing log of the same board size, - writes to stdout
+	bool open(const std::string& path, int size);
+	bool write(const std::uint8_t* events, std::size_t length);
+	bool close();
+
+	int size() const {
+		return header.size;
+	}
+
+	// false once a write failed
+	bool good() const {
+		return ok;
+	}
+
+private:
+	std::FILE* file;
+	GameLogHeader header;
+	bool ok;
+};
+
+// one event of a log, the atoms of LOG_GAME point into the mapped file
+struct GameLogEvent {
+	GameLogEventType type;
+	// number of atoms (LOG_GAME), entry (LOG_RAY), cell (LOG_PLACE, LOG_REMOVE) or penalty (LOG_EVALUATE)
+	int value;
+	// outcome of LOG_RAY
+	RayResult result;
+	const std::uint8_t* cells;
+
+	// cell of the i-th hidden atom of LOG_GAME
+	int atom(int i) const {
+		std::uint16_t cell;
+		std::memcpy(&cell, cells + 2*i, 2);
+		return cell;
+	}
+};
+
+// streams the events of a mapped log from the start
+class GameLogReader {
+public:
+	GameLogReader(): data(0), length(0), position(0), broken(false) {}
+	~GameLogReader() {
+		close();
+	}
+	bool open(const std::string& path);
+	void close();
+
+	int size() const {
+		return reinterpret_cast<const GameLogHeader*>(data)->size;
+	}
+
+	// the next event, false at the end of the log or at a truncated or unknown event (see corrupt)
+	bool next(GameLogEvent& event);
+
+	bool corrupt() const {
+		return broken;
+	}
+
+private:
+	bool read(std::uint16_t& value);
+
+	const std::uint8_t* data;
+	std::size_t length;
+	std::size_t position;
+	bool broken;
+};
+
+// plays the events of a log on a game of the same board size
+class GameLogReplay {
+public:
+	explicit GameLogReplay(Game& game);
+
+	// returns false if the game does not get the outcome or penalty of the log
+	bool play(const GameLogEvent& event);
+
+private:
+	Game& game;
+	std::vector<int> atoms;
+};
+
+#endif
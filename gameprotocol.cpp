@@ -0,0 +1,119 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "gameprotocol.h"
+#include "notation.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+// splits off the next word of a line, returns an empty word at the end
+char* nextWord(char*& rest) {
+	while (*rest == ' ' || *rest == '\t' || *rest == '\r') {
+		++rest;
+	}
+	char* word = rest;
+	while (*rest != '\0' && *rest != ' ' && *rest != '\t' && *rest != '\r') {
+		++rest;
+	}
+	if (*rest != '\0') {
+		*rest++ = '\0';
+	}
+	return word;
+}
+
+int answer(char* reply, const char* text) {
+	return std::snprintf(reply, GameProtocol::maxReply, "%s\n", text);
+}
+
+}
+
+GameProtocol::GameProtocol(Game& game): game(game), quit(false), count(0), evaluations(0) {
+}
+
+int GameProtocol::handle(char* line, char* reply) {
+	char* rest = line;
+	const char* command = nextWord(rest);
+	if (*command == '\0') {
+		return 0;
+	}
+	++count;
+	const char* argument = nextWord(rest);
+	if (*nextWord(rest) != '\0') {
+		return answer(reply, "error too many arguments");
+	}
+	const int size = game.size();
+
+	if (std::strcmp(command, "new") == 0) {
+		if (*argument != '\0') {
+			char* end;
+			unsigned long seed = std::strtoul(argument, &end, 10);
+			if (*end != '\0') {
+				return answer(reply, "error invalid seed");
+			}
+			game.seed(seed);
+		}
+		game.reset();
+		return std::snprintf(reply, maxReply, "ok %d %d\n", size, game.atoms());
+	}
+	if (std::strcmp(command, "quit") == 0) {
+		quit = true;
+		return answer(reply, "bye");
+	}
+	const bool move = std::strcmp(command, "fire") == 0 || std::strcmp(command, "place") == 0
+		|| std::strcmp(command, "remove") == 0 || std::strcmp(command, "evaluate") == 0;
+	if (!move) {
+		return answer(reply, "error unknown command");
+	}
+	if (game.evaluated()) {
+		return answer(reply, "error game evaluated");
+	}
+
+	if (std::strcmp(command, "fire") == 0) {
+		int entry = parseEntry(argument, size);
+		if (entry < 0) {
+			return answer(reply, "error invalid raycube");
+		}
+		RayResult result;
+		if (!game.fire(entry, &result)) {
+			return answer(reply, "error raycube used");
+		}
+		int length = writeResultName(reply, maxReply-1, result, size);
+		reply[length] = '\n';
+		return length+1;
+	}
+	if (std::strcmp(command, "evaluate") == 0) {
+		game.evaluate();
+		++evaluations;
+		return std::snprintf(reply, maxReply, "penalty %d found %d/%d\n", game.penalty(), game.atomsFound(), game.atoms());
+	}
+	int cell = parseCell(argument, size);
+	if (cell < 0) {
+		return answer(reply, "error invalid cell");
+	}
+	if (std::strcmp(command, "place") == 0) {
+		if (!game.placeAtom(cell)) {
+			return answer(reply, game.hasGuess(cell) ? "error atom placed already" : "error all atoms placed");
+		}
+	} else if (!game.removeAtom(cell)) {
+		return answer(reply, "error no atom placed");
+	}
+	return answer(reply, "ok");
+}
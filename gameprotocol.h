@@ -0,0 +1,71 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef BLACKBOX_GAMEPROTOCOL_H
+#define BLACKBOX_GAMEPROTOCOL_H
+
+#include "game.h"
+
+// the line protocol of blackbox-server, every request line gets exactly one reply line:
+//   new [seed]         a new game with random atoms    -> ok <size> <atoms>
+//   fire L3            shoot a ray                     -> hit, reflection or the raycube it left through
+//   place 3,4          place a guessed atom            -> ok
+//   remove 3,4         remove a guessed atom           -> ok
+//   evaluate           add the penalty of missed atoms -> penalty <points> found <found>/<atoms>
+//   quit               end the session                 -> bye
+// requests the rules do not allow get "error <reason>", empty lines get no reply
+// nothing here allocates, so a server can answer from fixed buffers
+class GameProtocol {
+public:
+	// longest reply including the newline
+	static const int maxReply = 64;
+
+	explicit GameProtocol(Game& game);
+
+	// answers one request (without the newline), the line is split in place
+	// reply needs room for maxReply chars, returns the length of the reply
+	int handle(char* line, char* reply);
+
+	// whether quit was requested
+	bool closed() const {
+		return quit;
+	}
+
+	// forget the quit to start another session on the same game
+	void reopen() {
+		quit = false;
+	}
+
+	// number of requests answered (over all sessions)
+	long requests() const {
+		return count;
+	}
+
+	// number of evaluated games
+	long games() const {
+		return evaluations;
+	}
+
+private:
+	Game& game;
+	bool quit;
+	long count;
+	long evaluations;
+};
+
+#endif
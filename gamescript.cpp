@@ -0,0 +1,115 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "gamescript.h"
+#include "notation.h"
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+
+GameScript::GameScript(Game& game, std::ostream& out): game(game), out(out), evaluations(0), count(0) {
+}
+
+bool GameScript::fail(const std::string& text) {
+	message = text;
+	return false;
+}
+
+bool GameScript::run(const std::string& line) {
+	std::istringstream words(line);
+	std::string command;
+	if (!(words >> command) || command[0] == '#') {
+		return true;
+	}
+	++count;
+	const int size = game.size();
+	std::string argument;
+	words >> argument;
+
+	if (command == "reset") {
+		game.reset();
+	} else if (command == "game") {
+		std::vector<int> atoms;
+		for (; !argument.empty(); argument.clear(), words >> argument) {
+			int cell = parseCell(argument, size);
+			if (cell < 0) {
+				return fail("invalid cell: " + argument);
+			}
+			atoms.push_back(cell);
+		}
+		game.reset(atoms);
+	} else if (command == "seed") {
+		char* end;
+		unsigned long seed = std::strtoul(argument.c_str(), &end, 10);
+		if (argument.empty() || *end != '\0') {
+			return fail("invalid seed: " + argument);
+		}
+		game.seed(seed);
+	} else if (command == "fire") {
+		int entry = parseEntry(argument, size);
+		if (entry < 0) {
+			return fail("invalid raycube: " + argument);
+		}
+		game.fire(entry);
+	} else if (command == "place" || command == "remove") {
+		int cell = parseCell(argument, size);
+		if (cell < 0) {
+			return fail("invalid cell: " + argument);
+		}
+		if (command == "place") {
+			game.placeAtom(cell);
+		} else {
+			game.removeAtom(cell);
+		}
+	} else if (command == "more") {
+		game.moreAtoms();
+	} else if (command == "fewer") {
+		game.fewerAtoms();
+	} else if (command == "evaluate") {
+		game.evaluate();
+		++evaluations;
+		out << "penalty: " << game.penalty() << " found: " << game.atomsFound() << "/" << game.atoms()
+			<< " rays: " << game.rays().size() << " " << game.rating() << "\n";
+	} else if (command == "show") {
+		printState();
+	} else {
+		return fail("unknown command: " + command);
+	}
+	return true;
+}
+
+void GameScript::printState() const {
+	// drawn with x to the right, the same way blackbox-solve draws boards
+	const int size = game.size();
+	for (int y = size-1; y >= 0; --y) {
+		for (int x = 0; x < size; ++x) {
+			int cell = x*size+y;
+			if (game.hasGuess(cell)) {
+				out << (game.hasAtom(cell) ? '@' : 'o');
+			} else {
+				out << (game.hasAtom(cell) ? '*' : '.');
+			}
+		}
+		out << "\n";
+	}
+	out << "rays:";
+	for (auto & ray : game.rays()) {
+		out << " " << entryName(ray.entry, size) << "=" << resultName(ray.result, size);
+	}
+	out << "\n";
+	out << "penalty: " << game.penalty() << (game.evaluated() ? "" : " (not evaluated)") << "\n";
+}
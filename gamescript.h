@@ -0,0 +1,70 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BLACKBOX_GAMESCRIPT_H
+#define BLACKBOX_GAMESCRIPT_H
+
+#include "game.h"
+#include <ostream>
+#include <string>
+
+// plays a game from scripted input instead of mouse clicks, one command per line:
+//   reset              new game with random atoms (the reset button)
+//   game 1,2 3,4 ...   new game with the given hidden atoms
+//   seed n             restart the random atoms of the following games
+//   fire L3            left click on a raycube
+//   place 3,4          left click on a cell
+//   remove 3,4         right click on a cell
+//   more, fewer        the + and - buttons
+//   evaluate           the evaluate button, prints the penalty
+//   show               prints the state of the game
+// empty lines and lines starting with # are skipped
+class GameScript {
+public:
+	GameScript(Game& game, std::ostream& out);
+
+	// runs one line, returns false for invalid commands (see error)
+	bool run(const std::string& line);
+
+	const std::string& error() const {
+		return message;
+	}
+
+	// number of evaluated games
+	int games() const {
+		return evaluations;
+	}
+
+	// number of commands run
+	int commands() const {
+		return count;
+	}
+
+	// prints the board (o for guesses, * for hidden atoms, @ for both), the rays and the penalty
+	void printState() const;
+
+private:
+	bool fail(const std::string& text);
+
+	Game& game;
+	std::ostream& out;
+	std::string message;
+	int evaluations;
+	int count;
+};
+
+#endif
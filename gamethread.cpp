@@ -0,0 +1,226 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "gamethread.h"
+#include <cmath>
+#include <utility>
+
+namespace {
+// how often a shown hint is asked for a better answer while its search runs
+const std::chrono::milliseconds hintPoll(20);
+}
+
+GameThread::GameThread(Game& game, HintEngine* hints, bool paths): game(game), hints(hints), paths(paths), signalled(false), stopping(false),
+	fresh(false), version(0), gameCount(0), hintOn(false), hintShown(false), hintStale(true), hintEntry(-1), hintGain(0) {
+	inputs.reserve(256);
+	if (paths) {
+		corners.reserve(4*game.size());
+		pathEnds.reserve(game.entryCount());
+		pathEntries.reserve(game.entryCount());
+	}
+	// the first snapshot is there before the first frame
+	publish();
+	thread = std::thread(&GameThread::run, this);
+}
+
+GameThread::~GameThread() {
+	stop();
+}
+
+bool GameThread::post(CommandType type, int value, Clock::time_point time) {
+	Command command = {type, value, time};
+	if (!commands.push(command)) {
+		return false;
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		signalled = true;
+	}
+	wake.notify_one();
+	return true;
+}
+
+bool GameThread::latest(GameSnapshot& snapshot) {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (!fresh) {
+		return false;
+	}
+	std::swap(front, snapshot);
+	fresh = false;
+	return true;
+}
+
+void GameThread::stop() {
+	if (!thread.joinable()) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_one();
+	thread.join();
+	if (hints) {
+		hints->stop();
+	}
+}
+
+void GameThread::run() {
+	std::unique_lock<std::mutex> lock(mutex);
+	for (;;) {
+		auto ready = [this] { return signalled || stopping; };
+		// a shown hint gets better while its search runs, so it is looked at now and then
+		if (hintOn) {
+			wake.wait_for(lock, hintPoll, ready);
+		} else {
+			wake.wait(lock, ready);
+		}
+		// commands posted before stop are still handled
+		bool last = stopping;
+		signalled = false;
+		lock.unlock();
+
+		bool changed = false;
+		Command command;
+		while (commands.pop(command)) {
+			changed = apply(command) || changed;
+			if (command.time != Clock::time_point()) {
+				inputs.push_back(command.time);
+			}
+		}
+		changed = updateHint() || changed;
+		// a click that changed nothing still has to be reported
+		if (changed || !inputs.empty()) {
+			publish();
+		}
+
+		lock.lock();
+		if (last) {
+			return;
+		}
+	}
+}
+
+bool GameThread::apply(const Command& command) {
+	switch (command.type) {
+	case CMD_FIRE:
+		if (!game.fire(command.value)) {
+			return false;
+		}
+		hintStale = true;
+		if (paths) {
+			game.rayPath(command.value, corners);
+			pathCorners.insert(pathCorners.end(), corners.begin(), corners.end());
+			pathEnds.push_back(static_cast<int>(pathCorners.size()));
+			pathEntries.push_back(command.value);
+		}
+		return true;
+	case CMD_PLACE:
+		return game.placeAtom(command.value);
+	case CMD_REMOVE:
+		return game.removeAtom(command.value);
+	case CMD_EVALUATE:
+		game.evaluate();
+		return true;
+	case CMD_RESET:
+		game.reset();
+		hintStale = true;
+		++gameCount;
+		pathCorners.clear();
+		pathEnds.clear();
+		pathEntries.clear();
+		return true;
+	case CMD_MORE_ATOMS:
+		return game.moreAtoms();
+	case CMD_FEWER_ATOMS:
+		return game.fewerAtoms();
+	case CMD_HINT_ON:
+		hintOn = hints != 0;
+		return false;
+	case CMD_HINT_OFF:
+		hintOn = false;
+		return false;
+	}
+	return false;
+}
+
+bool GameThread::updateHint() {
+	if (!hintOn) {
+		if (!hintShown) {
+			return false;
+		}
+		// the hint was hidden: drop its search and its raycube (whatever the game did meanwhile)
+		hints->stop();
+		hintShown = false;
+		hintStale = true;
+		hintEntry = -1;
+		hintGain = 0;
+		return true;
+	}
+	hintShown = true;
+	if (hintStale) {
+		hints->update(game.atoms(), game.rays());
+		hintStale = false;
+	}
+	HintEngine::Hint hint = hints->best();
+	// the gain is shown with one decimal
+	if (hint.entry == hintEntry && std::fabs(hint.gain - hintGain) < 0.05) {
+		return false;
+	}
+	hintEntry = hint.entry;
+	hintGain = hint.gain;
+	return true;
+}
+
+void GameThread::publish() {
+	back.version = ++version;
+	back.game = gameCount;
+	back.size = game.size();
+	back.penalty = game.penalty();
+	back.evaluated = game.evaluated();
+	back.rating = game.rating();
+	back.atomsChanged = game.atomsChanged();
+	back.nextAtoms = game.nextAtoms();
+	back.hintEntry = hintEntry;
+	back.hintGain = hintGain;
+	back.cells.resize(game.cells());
+	for (int cell = 0; cell < game.cells(); ++cell) {
+		std::uint8_t flags = game.hasGuess(cell) ? GameSnapshot::CELL_GUESS : 0;
+		if (game.evaluated() && game.hasAtom(cell)) {
+			flags |= GameSnapshot::CELL_ATOM;
+		}
+		back.cells[cell] = flags;
+	}
+	back.raycubes.resize(game.entryCount());
+	for (int entry = 0; entry < game.entryCount(); ++entry) {
+		back.raycubes[entry] = game.raycube(entry);
+	}
+	// the buffers keep their capacity, so this stops allocating once the paths are as long as they get
+	back.pathCorners = pathCorners;
+	back.pathEnds = pathEnds;
+	back.pathEntries = pathEntries;
+	back.inputs = inputs;
+	inputs.clear();
+
+	std::lock_guard<std::mutex> lock(mutex);
+	// inputs of a snapshot that was never taken are handed on to the next one
+	if (fresh) {
+		back.inputs.insert(back.inputs.begin(), front.inputs.begin(), front.inputs.end());
+	}
+	std::swap(front, back);
+	fresh = true;
+}
@@ -0,0 +1,150 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BLACKBOX_GAMETHREAD_H
+#define BLACKBOX_GAMETHREAD_H
+
+#include "game.h"
+#include "hint.h"
+#include "inputqueue.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// the state of a game as the board shows it, filled by the game thread and only read by the render thread
+struct GameSnapshot {
+	typedef std::chrono::steady_clock Clock;
+
+	// flags of a cell
+	enum {
+		CELL_GUESS = 1,		// an atom was placed on the cell
+		CELL_ATOM = 2		// the hidden atom of the cell is shown (after evaluation)
+	};
+
+	// counts the published snapshots
+	std::uint64_t version;
+	// counts the games, the paths start over with a new one
+	std::uint64_t game;
+	int size;
+	int penalty;
+	bool evaluated;
+	const char* rating;
+	bool atomsChanged;
+	int nextAtoms;
+	// the recommended entry (-1 without hint) and its information in bits
+	int hintEntry;
+	double hintGain;
+	std::vector<std::uint8_t> cells;
+	// Game::raycube of every entry
+	std::vector<int> raycubes;
+	// the paths of the fired rays one after the other (only if the thread was asked for them),
+	// path i ends before pathEnds[i] and was fired from pathEntries[i]
+	std::vector<RayPoint> pathCorners;
+	std::vector<int> pathEnds;
+	std::vector<int> pathEntries;
+	// arrival times of the timed commands that are handled in this snapshot (and none of an earlier one)
+	std::vector<Clock::time_point> inputs;
+
+	GameSnapshot(): version(0), game(0), size(0), penalty(0), evaluated(false), rating(""), atomsChanged(false), nextAtoms(0),
+		hintEntry(-1), hintGain(0) {}
+};
+
+// runs a game on a thread of its own, so rays, evaluation, new atoms and hints never hold up a frame
+// the render thread posts commands into a lock-free queue and picks up the newest snapshot once per frame;
+// the game thread fills a back buffer and swaps it with the published one, the render thread swaps the
+// published one with its own, so neither copies a board under the lock or waits for the other
+class GameThread {
+public:
+	typedef std::chrono::steady_clock Clock;
+
+	enum CommandType {
+		CMD_FIRE = 0,		// value: entry
+		CMD_PLACE,			// value: cell
+		CMD_REMOVE,			// value: cell
+		CMD_EVALUATE,
+		CMD_RESET,
+		CMD_MORE_ATOMS,
+		CMD_FEWER_ATOMS,
+		CMD_HINT_ON,
+		CMD_HINT_OFF
+	};
+
+	struct Command {
+		CommandType type;
+		int value;
+		// arrival of the input behind the command, the default time is not reported back
+		Clock::time_point time;
+	};
+
+	// the game and the hint engine (may be null) belong to the thread until stop
+	// with paths the snapshots carry the paths of the fired rays
+	GameThread(Game& game, HintEngine* hints, bool paths);
+	~GameThread();
+
+	// queue a command, returns false if the queue is full (the command is dropped)
+	bool post(CommandType type, int value = 0, Clock::time_point time = Clock::time_point());
+
+	// swap the newest snapshot into snapshot, returns false if there was none since the last call
+	bool latest(GameSnapshot& snapshot);
+
+	// handle the queued commands and end the thread, the game can be used again afterwards
+	void stop();
+
+private:
+	void run();
+	// returns whether the game changed
+	bool apply(const Command& command);
+	// returns whether a new hint has to be shown
+	bool updateHint();
+	void publish();
+
+	Game& game;
+	HintEngine* hints;
+	bool paths;
+	InputQueue<Command, 256> commands;
+
+	std::mutex mutex;
+	std::condition_variable wake;
+	bool signalled;
+	bool stopping;
+	// the published snapshot and whether the render thread has not taken it yet
+	GameSnapshot front;
+	bool fresh;
+
+	// only used by the game thread
+	GameSnapshot back;
+	std::uint64_t version;
+	std::uint64_t gameCount;
+	// the hint is wanted, it is shown (its search runs), the game changed since its search started
+	bool hintOn;
+	bool hintShown;
+	bool hintStale;
+	int hintEntry;
+	double hintGain;
+	std::vector<RayPoint> corners;
+	std::vector<RayPoint> pathCorners;
+	std::vector<int> pathEnds;
+	std::vector<int> pathEntries;
+	std::vector<Clock::time_point> inputs;
+
+	std::thread thread;
+};
+
+#endif
@@ -0,0 +1,272 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "pcgrandom.h"
+#include "puzzlefile.h"
+#include "raybatch.h"
+#include "solver.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// random boards traced together
+const int boardGroup = 64;
+// with filters the search gives up if none of the boards passed after this many groups (about a million
+// boards) or this long (uniqueness of many atoms can take a long time per board)
+const std::uint64_t barrenGroups = 1 << 14;
+const std::chrono::seconds barrenTime(30);
+
+struct Options {
+	int size = 8;
+	int atoms = 5;
+	std::uint64_t count = 1000000;
+	int threads = 0;
+	int minDistinct = 0;
+	bool unique = false;
+	bool seeded = false;
+	std::uint64_t seed = 0;
+	std::string output;
+};
+
+void usage() {
+	std::cerr << "usage: blackbox-gen [-s size] [-a atoms] [-c count] [-j threads] [-d min-distinct] [-u] [-S seed] -o file" << std::endl;
+	std::cerr << "  -a sets the number of atoms (at most 255)" << std::endl;
+	std::cerr << "  -d only keeps boards with at least this many different ray outcomes (at most 4*size+2)" << std::endl;
+	std::cerr << "  -u only keeps boards whose full signature has a unique solution" << std::endl;
+	std::cerr << "  -S draws the same boards on every run (the same file for any number of threads)" << std::endl;
+	std::cerr << "  -o - writes the records to stdout" << std::endl;
+}
+
+template <int Words>
+bool generate(const Options& options) {
+	typedef typename BasicBlackboxBoard<Words>::Bits Bits;
+
+	PuzzleWriter writer;
+	if (!writer.open(options.output, options.size, options.atoms, Words)) {
+		std::cerr << "could not open " << options.output << std::endl;
+		return false;
+	}
+	const std::size_t recordSize = writer.recordSize();
+	const int entries = 4*options.size;
+
+	unsigned int threads = options.threads > 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+
+	// every group of boards is drawn from its own stream of the seed, whichever thread takes it, and the
+	// records of the groups are written in group order, so a seed gives the same file for any thread count
+	// without filters the boards are exactly the first count boards of the streams
+	std::atomic<std::uint64_t> groups(0);
+	std::atomic<std::uint64_t> produced(0);
+	const bool filtered = options.minDistinct > 0 || options.unique;
+	std::atomic<bool> failed(false);
+	std::atomic<bool> barren(false);
+	std::atomic<bool> complete(false);
+	auto stopped = [&]() {
+		return complete.load() || failed.load() || barren.load();
+	};
+
+	// the groups that are done but wait for an earlier one, a worker does not start a group
+	// further ahead of the next one to write than the window (so a slow group costs no memory)
+	const std::uint64_t window = 4*threads;
+	std::vector<std::vector<std::uint8_t>> slots(window);
+	std::vector<char> ready(window, 0);
+	std::uint64_t nextGroup = 0;
+	std::mutex writeMutex;
+	std::condition_variable drained;
+	// hand over the records of a group and write all groups that are next in line
+	auto commit = [&](std::uint64_t group, std::vector<std::uint8_t>& records) {
+		std::lock_guard<std::mutex> lock(writeMutex);
+		slots[group % window].swap(records);
+		ready[group % window] = 1;
+		while (ready[nextGroup % window] && !stopped()) {
+			std::vector<std::uint8_t>& slot = slots[nextGroup % window];
+			const std::uint64_t written = produced.load();
+			const std::uint64_t count = std::min<std::uint64_t>(slot.size() / recordSize, options.count - written);
+			if (!writer.write(slot.data(), count)) {
+				failed.store(true);
+			}
+			produced.store(written + count);
+			if (written + count >= options.count) {
+				complete.store(true);
+			}
+			slot.clear();
+			ready[nextGroup % window] = 0;
+			++nextGroup;
+		}
+		drained.notify_all();
+	};
+
+	auto work = [&]() {
+		std::vector<int> order;
+		BasicRayBatch<Words> rays(options.size);
+		std::vector<Bits> boards(boardGroup);
+		std::vector<RayResult> results(boardGroup*entries);
+		std::vector<std::uint8_t> records;
+		records.reserve(boardGroup*recordSize);
+		std::vector<std::uint8_t> record(recordSize, 0);
+		std::vector<Observation> observations(entries);
+
+		while (!stopped()) {
+			const std::uint64_t group = groups.fetch_add(1);
+			if (!filtered && group*boardGroup >= options.count) {
+				break;
+			}
+			// filters nothing passes would keep every thread busy forever
+			if (filtered && group >= barrenGroups && produced.load() == 0) {
+				barren.store(true);
+				std::lock_guard<std::mutex> lock(writeMutex);
+				drained.notify_all();
+				break;
+			}
+			{
+				std::unique_lock<std::mutex> lock(writeMutex);
+				drained.wait(lock, [&] { return group < nextGroup + window || stopped(); });
+			}
+			if (stopped()) {
+				break;
+			}
+			Pcg32 rng(options.seed, group);
+			resetCells(order, options.size*options.size);
+			for (auto & bits : boards) {
+				randomAtoms(rng, order, options.atoms, bits);
+			}
+			rays.traceAll(boards.data(), boardGroup, results.data());
+
+			records.clear();
+			for (int b = 0; b < boardGroup; ++b) {
+				std::memcpy(record.data(), boards[b].words.data(), 8*Words);
+				std::uint8_t* signature = record.data() + 8*Words;
+				bool seen[256] = {};
+				int distinct = 0;
+				for (int entry = 0; entry < entries; ++entry) {
+					const RayResult& result = results[b*entries + entry];
+					signature[entry] = encodeResult(result);
+					distinct += !seen[signature[entry]];
+					seen[signature[entry]] = true;
+					observations[entry] = Observation(entry, result);
+				}
+				if (distinct < options.minDistinct) {
+					continue;
+				}
+				if (options.unique) {
+					auto result = BasicSolver<Words>(options.size, options.atoms, observations).solve(1, 2, 0, &barren);
+					if (!result.complete || result.count != 1) {
+						continue;
+					}
+				}
+				records.insert(records.end(), record.begin(), record.end());
+			}
+			commit(group, records);
+		}
+	};
+
+	// this thread only watches the workers, so it can stop filters that nothing passes
+	std::mutex doneMutex;
+	std::condition_variable done;
+	unsigned int running = threads;
+	std::vector<std::thread> workers;
+	for (unsigned int i = 0; i < threads; ++i) {
+		workers.emplace_back([&]() {
+			work();
+			std::lock_guard<std::mutex> lock(doneMutex);
+			--running;
+			done.notify_one();
+		});
+	}
+	{
+		std::unique_lock<std::mutex> lock(doneMutex);
+		if (filtered && !done.wait_for(lock, barrenTime, [&] { return running == 0 || produced.load() > 0; })) {
+			// cancels the solvers that are running too
+			barren.store(true);
+		}
+	}
+	{
+		std::lock_guard<std::mutex> lock(writeMutex);
+		drained.notify_all();
+	}
+	for (auto & worker : workers) {
+		worker.join();
+	}
+	if (barren.load()) {
+		writer.close();
+		std::cerr << "no board passed the filters" << std::endl;
+		return false;
+	}
+	if (!writer.close() || failed.load()) {
+		std::cerr << "writing " << options.output << " failed" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+}
+
+int main(int argc, char** argv) {
+	Options options;
+	for (int i = 1; i < argc; ++i) {
+		if (!std::strcmp(argv[i], "-s") && i+1 < argc) {
+			options.size = std::atoi(argv[++i]);
+		} else if (!std::strcmp(argv[i], "-a") && i+1 < argc) {
+			options.atoms = std::atoi(argv[++i]);
+		} else if (!std::strcmp(argv[i], "-c") && i+1 < argc) {
+			options.count = std::strtoull(argv[++i], 0, 10);
+		} else if (!std::strcmp(argv[i], "-j") && i+1 < argc) {
+			options.threads = std::atoi(argv[++i]);
+		} else if (!std::strcmp(argv[i], "-d") && i+1 < argc) {
+			options.minDistinct = std::atoi(argv[++i]);
+		} else if (!std::strcmp(argv[i], "-S") && i+1 < argc) {
+			options.seed = std::strtoull(argv[++i], 0, 10);
+			options.seeded = true;
+		} else if (!std::strcmp(argv[i], "-u")) {
+			options.unique = true;
+		} else if (!std::strcmp(argv[i], "-o") && i+1 < argc) {
+			options.output = argv[++i];
+		} else {
+			usage();
+			return 1;
+		}
+	}
+	// the header keeps the number of atoms in a byte
+	if (options.output.empty() || options.size < 1 || options.size*options.size > WideBlackboxBoard::maxCells
+	|| options.atoms < 1 || options.atoms > std::min(options.size*options.size, 255) || options.minDistinct > 4*options.size+2) {
+		usage();
+		return 1;
+	}
+
+	if (!options.seeded) {
+		std::random_device seeds;
+		options.seed = (std::uint64_t(seeds()) << 32) ^ seeds();
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	bool ok = options.size*options.size <= BlackboxBoard::maxCells ? generate<1>(options) : generate<4>(options);
+	if (!ok) {
+		return 1;
+	}
+	std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+	std::cerr << options.count << " boards in " << seconds.count() << " s" << std::endl;
+	return 0;
+}
@@ -0,0 +1,336 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "hint.h"
+#include "gameboard.h"
+#include "pcgrandom.h"
+#include "raybatch.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+// placements the exact enumeration may find before sampling is left to do the job
+const std::uint64_t exactLimit = 20000;
+// the enumeration only starts if the samples estimate at most this many fitting placements
+const double enumerationEstimate = 4.0 * exactLimit;
+// a sampler hands over its counts after this many fitting placements or tries
+const int batchSamples = 32;
+const int batchTries = 2048;
+// random placements drawn and checked together
+const int candidateGroup = 64;
+// sampling stops after this many fitting placements, the answer hardly changes any more
+const std::uint64_t maxSamples = 1 << 20;
+
+template <int Words>
+class BasicHintEngine : public HintEngine {
+public:
+	typedef BasicBlackboxBoard<Words> Board;
+	typedef typename Board::Bits Bits;
+
+	BasicHintEngine(int size, int threads, std::uint64_t seed): size(size), outcomes(2 + 4*size), threads(threads), atoms(0), seeds(seed, 2),
+		cancel(false), finished(false), enumerating(false), generation(0), busy(0), quitting(false), tried(0) {
+		if (this->threads <= 0) {
+			this->threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+		}
+		// the samplers and the enumeration are started once and wait for the updates
+		for (int i = 0; i < this->threads; ++i) {
+			workers.emplace_back(&BasicHintEngine::work, this, i);
+		}
+		workers.emplace_back(&BasicHintEngine::work, this, -1);
+	}
+
+	~BasicHintEngine() {
+		stop();
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			quitting = true;
+		}
+		wake.notify_all();
+		for (auto & worker : workers) {
+			worker.join();
+		}
+	}
+
+	void update(int atoms, const std::vector<Observation>& observations) {
+		stop();
+		this->atoms = atoms;
+		this->observations = observations;
+		used.assign(4*size, 0);
+		for (auto & observation : observations) {
+			used[observation.entry] = 1;
+			if (observation.result.outcome == RAY_EXIT) {
+				used[observation.result.exit] = 1;
+			}
+		}
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			counts.assign(4*size*outcomes, 0);
+			tried = 0;
+			current = Hint();
+			cancel.store(false);
+			finished.store(false);
+			enumerating.store(false);
+			// one seed per update (drawn from the seed of the engine), every sampler draws from its own stream of it
+			updateSeed = (std::uint64_t(seeds()) << 32) ^ seeds();
+			busy = static_cast<int>(workers.size());
+			++generation;
+		}
+		wake.notify_all();
+	}
+
+	Hint best() const {
+		std::lock_guard<std::mutex> lock(mutex);
+		return current;
+	}
+
+	Hint waitFor(std::chrono::milliseconds timeout) const {
+		std::unique_lock<std::mutex> lock(mutex);
+		done.wait_for(lock, timeout, [&]() { return current.exact; });
+		return current;
+	}
+
+	void stop() {
+		std::unique_lock<std::mutex> lock(mutex);
+		cancel.store(true);
+		done.notify_all();
+		idle.wait(lock, [&]() { return busy == 0; });
+	}
+
+private:
+	static int outcomeIndex(const RayResult& result) {
+		return result.outcome == RAY_EXIT ? 2 + result.exit : result.outcome;
+	}
+
+	// add the outcomes of the unused entries of a fitting placement (all entries traced, in entry order)
+	void count(const RayResult* row, std::vector<std::uint64_t>& batch) const {
+		for (int entry = 0; entry < 4*size; ++entry) {
+			if (!used[entry]) {
+				++batch[entry*outcomes + outcomeIndex(row[entry])];
+			}
+		}
+	}
+
+	// a sampler (stream >= 0) or the enumeration (stream -1), runs once for every update
+	void work(int stream) {
+		std::uint64_t seen = 0;
+		for (;;) {
+			std::uint64_t seed;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				wake.wait(lock, [&]() { return quitting || generation != seen; });
+				if (quitting) {
+					return;
+				}
+				seen = generation;
+				seed = updateSeed;
+			}
+			if (stream < 0) {
+				enumerate();
+			} else {
+				sample(seed, stream);
+			}
+			std::lock_guard<std::mutex> lock(mutex);
+			if (--busy == 0) {
+				idle.notify_all();
+			}
+		}
+	}
+
+	// rejection sampling: random placements that do not fit the observations are dropped
+	// the placements are drawn in groups and each observation is checked on all that are left at once
+	void sample(std::uint64_t seed, int stream) {
+		Pcg32 random(seed, stream);
+		std::vector<int> order;
+		resetCells(order, size*size);
+		BasicRayBatch<Words> rays(size);
+		std::vector<Bits> candidates(candidateGroup);
+		std::vector<RayResult> results(candidateGroup*4*size);
+		std::vector<std::uint64_t> batch(4*size*outcomes, 0);
+		while (!cancel.load(std::memory_order_relaxed) && !finished.load(std::memory_order_relaxed)) {
+			if (enumerating.load(std::memory_order_relaxed)) {
+				// leave the cores to the enumeration, it is expected to be done soon
+				std::unique_lock<std::mutex> lock(mutex);
+				done.wait(lock, [&]() { return !enumerating.load() || cancel.load(); });
+				continue;
+			}
+			int samples = 0;
+			int tries = 0;
+			for (; tries < batchTries && samples < batchSamples && !cancel.load(std::memory_order_relaxed); tries += candidateGroup) {
+				for (auto & bits : candidates) {
+					randomAtoms(random, order, atoms, bits);
+				}
+				int fitting = candidateGroup;
+				for (auto & observation : observations) {
+					rays.traceBoards(candidates.data(), fitting, observation.entry, results.data());
+					int kept = 0;
+					for (int i = 0; i < fitting; ++i) {
+						if (results[i] == observation.result) {
+							candidates[kept++] = candidates[i];
+						}
+					}
+					fitting = kept;
+				}
+				rays.traceAll(candidates.data(), fitting, results.data());
+				for (int i = 0; i < fitting; ++i) {
+					count(&results[i*4*size], batch);
+				}
+				samples += fitting;
+			}
+			publish(batch, samples, tries, false);
+			if (samples) {
+				std::fill(batch.begin(), batch.end(), 0);
+			}
+		}
+	}
+
+	// all fitting placements, if there are only a few
+	void enumerate() {
+		if (observations.size() > 64) {
+			return;
+		}
+		{
+			// the share of fitting random placements tells how many there are, too many take
+			// long to enumerate (and to cancel) while sampling them works well
+			std::unique_lock<std::mutex> lock(mutex);
+			done.wait(lock, [&]() { return tried > 0 || cancel.load(); });
+			double placements = std::exp(std::lgamma(size*size + 1.0) - std::lgamma(atoms + 1.0) - std::lgamma(size*size - atoms + 1.0));
+			if (cancel.load() || current.samples * placements > enumerationEstimate * tried) {
+				return;
+			}
+			enumerating.store(true);
+		}
+		BasicSolver<Words> solver(size, atoms, observations);
+		typename BasicSolver<Words>::Result result = solver.solve(threads, exactLimit+1, exactLimit, &cancel);
+		if (!result.complete || cancel.load()) {
+			// too many after all, back to sampling
+			std::lock_guard<std::mutex> lock(mutex);
+			enumerating.store(false);
+			done.notify_all();
+			return;
+		}
+		std::vector<Bits> solutions;
+		for (auto & board : result.solutions) {
+			solutions.push_back(board.atoms());
+		}
+		std::vector<RayResult> results(solutions.size()*4*size);
+		BasicRayBatch<Words>(size).traceAll(solutions.data(), solutions.size(), results.data());
+		std::vector<std::uint64_t> batch(4*size*outcomes, 0);
+		for (std::size_t i = 0; i < solutions.size(); ++i) {
+			count(&results[i*4*size], batch);
+		}
+		finished.store(true);
+		publish(batch, result.solutions.size(), 0, true);
+		std::lock_guard<std::mutex> lock(mutex);
+		enumerating.store(false);
+		done.notify_all();
+	}
+
+	void publish(const std::vector<std::uint64_t>& batch, std::uint64_t samples, std::uint64_t tries, bool exact) {
+		std::lock_guard<std::mutex> lock(mutex);
+		tried += tries;
+		if (current.exact || (!exact && samples == 0)) {
+			done.notify_all();
+			return;
+		}
+		if (exact) {
+			counts = batch;
+			current.samples = samples;
+		} else {
+			for (std::size_t i = 0; i < counts.size(); ++i) {
+				counts[i] += batch[i];
+			}
+			current.samples += samples;
+			if (current.samples >= maxSamples) {
+				finished.store(true);
+			}
+		}
+		current.exact = exact;
+		current.entry = -1;
+		current.gain = 0;
+		for (int entry = 0; entry < 4*size; ++entry) {
+			if (used[entry] || current.samples == 0) {
+				continue;
+			}
+			// entropy of the outcome
+			double gain = 0;
+			for (int i = 0; i < outcomes; ++i) {
+				std::uint64_t n = counts[entry*outcomes + i];
+				if (n) {
+					double p = static_cast<double>(n) / current.samples;
+					gain -= p * std::log2(p);
+				}
+			}
+			if (current.entry < 0 || gain > current.gain) {
+				current.entry = entry;
+				current.gain = gain;
+			}
+		}
+		done.notify_all();
+	}
+
+	const int size;
+	const int outcomes;
+	int threads;
+	int atoms;
+	std::vector<Observation> observations;
+	std::vector<char> used;
+	// the seeds of the updates
+	Pcg32 seeds;
+	std::atomic<bool> cancel;
+	// the exact answer is known, sampling can stop
+	std::atomic<bool> finished;
+	// sampling pauses while all fitting placements are enumerated
+	std::atomic<bool> enumerating;
+	std::vector<std::thread> workers;
+
+	mutable std::mutex mutex;
+	mutable std::condition_variable done;
+	// wakes the workers for an update (or to quit) and tells stop that all of them are idle
+	std::condition_variable wake;
+	std::condition_variable idle;
+	std::uint64_t generation;
+	std::uint64_t updateSeed;
+	int busy;
+	bool quitting;
+	std::vector<std::uint64_t> counts;
+	// random placements the samplers tried so far
+	std::uint64_t tried;
+	Hint current;
+};
+
+}
+
+std::unique_ptr<HintEngine> createHintEngine(int size, std::uint64_t seed, int threads) {
+	if (size < 1 || size > maxBoardSize) {
+		return std::unique_ptr<HintEngine>();
+	}
+	if (size <= 8) {
+		return std::unique_ptr<HintEngine>(new BasicHintEngine<1>(size, threads, seed));
+	}
+	if (size <= 16) {
+		return std::unique_ptr<HintEngine>(new BasicHintEngine<4>(size, threads, seed));
+	}
+	if (size <= 32) {
+		return std::unique_ptr<HintEngine>(new BasicHintEngine<16>(size, threads, seed));
+	}
+	return std::unique_ptr<HintEngine>(new BasicHintEngine<64>(size, threads, seed));
+}
@@ -0,0 +1,62 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BLACKBOX_HINT_H
+#define BLACKBOX_HINT_H
+
+#include "solver.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// recommends the raycube to fire next: the unused entry whose outcome is the most uncertain
+// over the atom placements that still fit the rays fired so far, which is the entry with the
+// highest expected information gain (every fitting placement counts the same)
+// the placements are sampled on background threads right away and enumerated exactly as soon as
+// few enough of them are left, so the answer gets better over time (sampling ends after about
+// a million placements)
+class HintEngine {
+public:
+	struct Hint {
+		int entry;				// -1 while nothing was sampled yet (or no placement fits)
+		double gain;			// expected information of the outcome in bits
+		std::uint64_t samples;	// placements the answer is based on
+		bool exact;				// all fitting placements were counted
+		Hint(): entry(-1), gain(0), samples(0), exact(false) {}
+	};
+
+	virtual ~HintEngine() {}
+
+	// start over for a new game state, the previous search is dropped
+	virtual void update(int atoms, const std::vector<Observation>& observations) = 0;
+
+	// stop the background search, the last answer stays
+	virtual void stop() = 0;
+
+	// the best entry found so far, never blocks
+	virtual Hint best() const = 0;
+
+	// waits until the answer is exact or the time is up
+	virtual Hint waitFor(std::chrono::milliseconds timeout) const = 0;
+};
+
+// the samples are drawn from the seed (the same seed and rays give the same samples in every thread)
+// threads = 0 uses all cores but one (which is left for rendering), returns null for unsupported sizes
+std::unique_ptr<HintEngine> createHintEngine(int size, std::uint64_t seed, int threads = 0);
+
+#endif
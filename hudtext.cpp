@@ -0,0 +1,46 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "hudtext.h"
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+using namespace irr;
+
+HudText::HudText() {
+	current[0] = '\0';
+	text.reserve(maxLength);
+}
+
+const core::stringw& HudText::get(const char* format, ...) {
+	char formatted[maxLength];
+	va_list arguments;
+	va_start(arguments, format);
+	std::vsnprintf(formatted, maxLength, format, arguments);
+	va_end(arguments);
+	if (std::strcmp(formatted, current) != 0) {
+		std::strcpy(current, formatted);
+		// copying a string only allocates if the target is too small, appending within the reserved size never does
+		static const core::stringw empty;
+		text = empty;
+		for (const char* c = formatted; *c; ++c) {
+			text.append(static_cast<wchar_t>(*c));
+		}
+	}
+	return text;
+}
@@ -0,0 +1,38 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BLACKBOX_HUDTEXT_H
+#define BLACKBOX_HUDTEXT_H
+
+#include <irrlicht.h>
+
+// a line of text drawn every frame, it is only converted for the font when it changes
+// and then reuses the buffer of the string (assigning a char pointer to a string always allocates)
+class HudText {
+public:
+	HudText();
+
+	// printf style, returns the text to draw
+	const irr::core::stringw& get(const char* format, ...);
+
+private:
+	static const int maxLength = 64;
+	char current[maxLength];
+	irr::core::stringw text;
+};
+
+#endif
@@ -0,0 +1,85 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BLACKBOX_INPUTQUEUE_H
+#define BLACKBOX_INPUTQUEUE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+// a mouse button press at a screen position and the time it arrived
+struct InputEvent {
+	enum Button {
+		BUTTON_LEFT = 0,
+		BUTTON_RIGHT
+	};
+
+	Button button;
+	int x;
+	int y;
+	std::chrono::steady_clock::time_point time;
+};
+
+// a fixed size ring of events for one producer (the event receiver) and one consumer (the main loop)
+// push and pop never block or allocate, a push into a full queue is dropped and counted
+template <class T, std::size_t Capacity>
+class InputQueue {
+	static_assert(Capacity > 0 && (Capacity & (Capacity-1)) == 0, "the capacity has to be a power of two");
+
+public:
+	InputQueue(): head(0), tail(0), dropped(0) {}
+
+	bool push(const T& item) {
+		std::size_t t = tail.load(std::memory_order_relaxed);
+		if (t - head.load(std::memory_order_acquire) == Capacity) {
+			dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		items[t & (Capacity-1)] = item;
+		tail.store(t+1, std::memory_order_release);
+		return true;
+	}
+
+	bool pop(T& item) {
+		std::size_t h = head.load(std::memory_order_relaxed);
+		if (h == tail.load(std::memory_order_acquire)) {
+			return false;
+		}
+		item = items[h & (Capacity-1)];
+		head.store(h+1, std::memory_order_release);
+		return true;
+	}
+
+	bool empty() const {
+		return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+	}
+
+	// number of events that did not fit so far
+	std::size_t droppedCount() const {
+		return dropped.load(std::memory_order_relaxed);
+	}
+
+private:
+	T items[Capacity];
+	// producer and consumer each write their own counter on a cache line of its own
+	alignas(64) std::atomic<std::size_t> head;
+	alignas(64) std::atomic<std::size_t> tail;
+	std::atomic<std::size_t> dropped;
+};
+
+#endif
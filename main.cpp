@@ -16,12 +16,28 @@
 //  along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <irrlicht.h>
+#include "game.h"
+#include "gamescript.h"
+#include "hint.h"
+#include "gamethread.h"
+#include "picker.h"
+#include "boardnode.h"
+#include "boardview.h"
+#include "volumenode.h"
+#include "tournament.h"
+#include "raypathnode.h"
+#include "assets.h"
+#include "hudtext.h"
+#include "allocationcounter.h"
+#include "framepacer.h"
+#include "frameprofiler.h"
+#include "inputqueue.h"
 #include <vector>
 #include <algorithm>
 #include <iostream>
+#include <fstream>
 #include <cstdlib>
-#include <ctime>
-#include <sstream>
+#include <chrono>
 #include <string>
 #include <random>
 
@@ -32,58 +48,60 @@ enum {
 	GUI_ID_EVALUATE_BUTTON,
 	GUI_ID_HELP_BUTTON,
 	GUI_ID_MINUS_BUTTON,
-	GUI_ID_PLUS_BUTTON
+	GUI_ID_PLUS_BUTTON,
+	GUI_ID_HINT_BUTTON
 };
 
 // based on example 19 of irrlicht docs
 class MyEventReceiver : public IEventReceiver {
 public:
-	// record info on the mouse state
-	struct SMouseState {
-		core::position2di pos;
-		bool leftButtonDown;
-		bool rightButtonDown;
-		SMouseState(): leftButtonDown(false), rightButtonDown(false) {}
-	} mouseState;
+	// the mouse button presses in the order they came, each one is handled exactly once by the main loop
+	InputQueue<InputEvent, 64> clicks;
 	struct SAppContext {
 		IrrlichtDevice *device;
 		bool reset;
 		bool eval;
 		bool help;
+		bool hint;
 		bool decreaseAtoms;
 		bool increaseAtoms;
-		SAppContext(): reset(false), eval(false), help(false), decreaseAtoms(false), increaseAtoms(false) {}
+		bool redraw;
+		// layers to move up (or down) on a volume
+		int layerChange;
+		SAppContext(): reset(false), eval(false), help(false), hint(false), decreaseAtoms(false), increaseAtoms(false), redraw(true), layerChange(0) {}
 	} context;
 
-	// track mouse movements and clicks
+	// track mouse clicks and the keys and wheel that change the layer
 	virtual bool OnEvent(const SEvent& event) {
+		// any input may change the gui (hovered buttons etc.)
+		if (event.EventType == EET_MOUSE_INPUT_EVENT || event.EventType == EET_GUI_EVENT || event.EventType == EET_KEY_INPUT_EVENT) {
+			context.redraw = true;
+		}
 		if (event.EventType == EET_MOUSE_INPUT_EVENT) {
 			switch(event.MouseInput.Event) {
 			case EMIE_LMOUSE_PRESSED_DOWN:
-				mouseState.leftButtonDown = true;
-				break;
-
-			case EMIE_LMOUSE_LEFT_UP:
-				mouseState.leftButtonDown = false;
+				clicks.push(InputEvent{InputEvent::BUTTON_LEFT, event.MouseInput.X, event.MouseInput.Y, std::chrono::steady_clock::now()});
 				break;
 
 			case EMIE_RMOUSE_PRESSED_DOWN:
-				mouseState.rightButtonDown = true;
-				break;
-
-			case EMIE_RMOUSE_LEFT_UP:
-				mouseState.rightButtonDown = false;
+				clicks.push(InputEvent{InputEvent::BUTTON_RIGHT, event.MouseInput.X, event.MouseInput.Y, std::chrono::steady_clock::now()});
 				break;
 
-			case EMIE_MOUSE_MOVED:
-				mouseState.pos.X = event.MouseInput.X;
-				mouseState.pos.Y = event.MouseInput.Y;
+			case EMIE_MOUSE_WHEEL:
+				context.layerChange += event.MouseInput.Wheel > 0 ? 1 : -1;
 				break;
 
 			default:
 				break;
 			}
 		}
+		if (event.EventType == EET_KEY_INPUT_EVENT && event.KeyInput.PressedDown) {
+			if (event.KeyInput.Key == KEY_UP || event.KeyInput.Key == KEY_PRIOR) {
+				++context.layerChange;
+			} else if (event.KeyInput.Key == KEY_DOWN || event.KeyInput.Key == KEY_NEXT) {
+				--context.layerChange;
+			}
+		}
 		// track gui clicks
 		if (event.EventType == EET_GUI_EVENT) {
 			s32 id = event.GUIEvent.Caller->getID();
@@ -107,6 +125,9 @@ public:
 						case GUI_ID_PLUS_BUTTON:
 							context.increaseAtoms = true;
 							break;
+						case GUI_ID_HINT_BUTTON:
+							context.hint = !context.hint;
+							break;
 						default:
 							break;
 					}
@@ -118,72 +139,441 @@ public:
 	}
 };
 
-scene::ISceneNode* createNode(video::IVideoDriver* driver, scene::ISceneManager* smgr, scene::IMesh* mesh, core::vector3df pos, video::SColor color, int id=-1) {
-	scene::ISceneNode* node = smgr->addMeshSceneNode(mesh);
-	if (node) {
-		// add a texture to the cube and disable lighting as there is no light
-		node->setMaterialFlag(video::EMF_LIGHTING, true);
-		node->setMaterialFlag(video::EMF_BILINEAR_FILTER, false);
-		//node->setMaterialTexture(0, driver->getTexture("../models/cube.png"));
-		node->getMaterial(0).Shininess = 20.0f;
-		node->getMaterial(0).AmbientColor = color;
-		// correct Blender rotation for Irrlicht (not really necessary for a cube, just for reference)
-		node->setRotation(core::vector3df(0,0,180));
-		node->setPosition(pos);
-		node->setID(id);
+const video::SColor textcolor(255,255,255,255);
+// the most games side by side (--boards)
+const int maxBoards = 16;
+
+// where a button goes for the width of the window
+core::rect<s32> buttonRect(s32 id, int screenX) {
+	switch (id) {
+		case GUI_ID_EVALUATE_BUTTON:
+			return core::rect<s32>(10,10,200,50);
+		case GUI_ID_RESET_BUTTON:
+			return core::rect<s32>(screenX-10-190,10,screenX-10,50);
+		case GUI_ID_HELP_BUTTON:
+			return core::rect<s32>(220,10,260,50);
+		case GUI_ID_MINUS_BUTTON:
+			return core::rect<s32>(screenX-10-190-50,10,screenX-10-190-10,50);
+		case GUI_ID_HINT_BUTTON:
+			return core::rect<s32>(270,10,350,50);
+		default:
+			return core::rect<s32>(screenX-10-190-50-40,10,screenX-10-190-50,50);
 	}
-	return node;
 }
 
 void buildGUI(gui::IGUIEnvironment* guienv, int screenX) {
-	guienv->addButton(core::rect<s32>(10,10,200,50), 0, GUI_ID_EVALUATE_BUTTON, L"Evaluate", L"Show Results");
-	guienv->addButton(core::rect<s32>(screenX-10-190,10,screenX-10,50), 0, GUI_ID_RESET_BUTTON, L"Reset", L"Reset Game");
-	guienv->addButton(core::rect<s32>(220,10,260,50), 0, GUI_ID_HELP_BUTTON, L"?");
-	guienv->addButton(core::rect<s32>(screenX-10-190-50,10,screenX-10-190-10,50), 0, GUI_ID_MINUS_BUTTON, L"-", L"Reduce the Number of Atoms (After Next Reset)");
-	guienv->addButton(core::rect<s32>(screenX-10-190-50-40,10,screenX-10-190-50,50), 0, GUI_ID_PLUS_BUTTON, L"+", L"Increase the Number of Atoms (After Next Reset)");
+	guienv->addButton(buttonRect(GUI_ID_EVALUATE_BUTTON, screenX), 0, GUI_ID_EVALUATE_BUTTON, L"Evaluate", L"Show Results");
+	guienv->addButton(buttonRect(GUI_ID_RESET_BUTTON, screenX), 0, GUI_ID_RESET_BUTTON, L"Reset", L"Reset Game");
+	guienv->addButton(buttonRect(GUI_ID_HELP_BUTTON, screenX), 0, GUI_ID_HELP_BUTTON, L"?");
+	guienv->addButton(buttonRect(GUI_ID_MINUS_BUTTON, screenX), 0, GUI_ID_MINUS_BUTTON, L"-", L"Reduce the Number of Atoms (After Next Reset)");
+	guienv->addButton(buttonRect(GUI_ID_PLUS_BUTTON, screenX), 0, GUI_ID_PLUS_BUTTON, L"+", L"Increase the Number of Atoms (After Next Reset)");
+	guienv->addButton(buttonRect(GUI_ID_HINT_BUTTON, screenX), 0, GUI_ID_HINT_BUTTON, L"Hint", L"Show the Raycube that Tells the Most");
 }
 
-// based on https://en.wikipedia.org/wiki/Web_colors
-std::vector<video::SColor> colors {
-	video::SColor(255, 128, 0, 128),	// Purple
-	video::SColor(255, 128, 0, 0),		// Maroon
-	video::SColor(255, 128, 128, 0),	// Olive
-	video::SColor(255, 0, 128, 128),	// Teal
-	video::SColor(255, 250, 128, 114),	// Salmon
-	video::SColor(255, 220, 20, 60),	// Crimson
-	video::SColor(255, 139, 0, 0),		// DarkRed
-	video::SColor(255, 255, 69, 0),		// OrangeRed
-	video::SColor(255, 255, 165, 0),	// Orange
-	video::SColor(255, 255, 215, 0),	// Gold
-	video::SColor(255, 0, 0, 255),		// Blue
-	video::SColor(255, 188, 143, 143),	// RosyBrown
-	video::SColor(255, 189, 183, 107),	// DarkKhaki
-	video::SColor(255, 0, 100, 0),		// DarkGreen
-	video::SColor(255, 210, 105, 30),	// Chocolate
-	video::SColor(255, 139, 69, 19),	// SaddleBrown
-	video::SColor(255, 85, 107, 47),	// DarkOliveGreen
-	video::SColor(255, 173, 255, 47),	// GreenYellow
-	video::SColor(255, 50, 205, 50),	// LimeGreen
-	video::SColor(255, 124, 252, 0),	// LawnGreen
-	video::SColor(255, 0, 255, 127),	// SpringGreen
-	video::SColor(255, 47, 79, 79),		// DarkSlateGray
-	video::SColor(255, 102, 205, 170),	// MediumAquamarine
-	video::SColor(255, 127, 255, 212),	// Aquamarine
-	video::SColor(255, 0, 206, 209),	// DarkTurquoise
-	video::SColor(255, 176, 224, 230),	// PowderBlue
-	video::SColor(255, 0, 191, 255),	// DeepSkyBlue
-	video::SColor(255, 100, 149, 237),	// CornflowerBlue
-	video::SColor(255, 238, 130, 238),	// Violet
-	video::SColor(255, 138, 43, 226),	// BlueViolet
-	video::SColor(255, 75, 0, 130),		// Indigo
-	video::SColor(255, 255, 192, 203),	// Pink
-	video::SColor(255, 255, 20, 147),	// DeepPink
-	video::SColor(255, 199, 21, 133)	// MediumVioletRed
-};
+// set up the skin and the buttons, returns the font of the texts
+gui::IGUIFont* setupGUI(gui::IGUIEnvironment* guienv, int screenX) {
+	gui::IGUIFont* font = guienv->getFont("../fonts/bigfont.png");
+	if (!font) {
+		std::cout << "font not found" << std::endl;
+		font = guienv->getBuiltInFont();
+	}
+	guienv->getSkin()->setFont(font);
+	guienv->getSkin()->setColor(gui::EGUI_DEFAULT_COLOR::EGDC_BUTTON_TEXT, textcolor);
+	guienv->getSkin()->setColor(gui::EGUI_DEFAULT_COLOR::EGDC_TOOLTIP, textcolor);
+	buildGUI(guienv, screenX);
+	return font;
+}
+
+// move the buttons for a new window width (instead of building the gui again)
+void layoutGUI(gui::IGUIEnvironment* guienv, int screenX) {
+	for (s32 id = GUI_ID_RESET_BUTTON; id <= GUI_ID_HINT_BUTTON; ++id) {
+		gui::IGUIElement* button = guienv->getRootGUIElement()->getElementFromId(id);
+		if (button) {
+			button->setRelativePosition(buttonRect(id, screenX));
+		}
+	}
+}
+
+// play a script on the null driver, the board node is kept up to date just like in the window
+int runHeadless(int gameBoardSize, const std::string& scriptName, const std::string& logFile) {
+	std::ifstream file;
+	if (scriptName != "-") {
+		file.open(scriptName);
+		if (!file) {
+			std::cerr << "cannot open " << scriptName << std::endl;
+			return 1;
+		}
+	}
+	std::istream& script = scriptName == "-" ? std::cin : file;
+
+	IrrlichtDevice *device = createDevice(video::EDT_NULL);
+	if (device == 0) {
+		return 1;
+	}
+	video::IVideoDriver* driver = device->getVideoDriver();
+	scene::ISceneManager* smgr = device->getSceneManager();
+	scene::SMesh* cube = createBakedMesh(cubeMesh);
+	scene::SMesh* atom = createBakedMesh(atomMesh);
+	BoardSceneNode* boardNode = new BoardSceneNode(smgr->getRootSceneNode(), smgr, gameBoardSize, -(3*gameBoardSize)/2, cube, atom, cubeColor, raycubeColor, atomColor);
+	boardNode->drop();
+	cube->drop();
+	atom->drop();
+	smgr->addCameraSceneNode(0, core::vector3df(0,-30,0), core::vector3df(0,0,0));
+
+	// the random atoms only depend on the seed commands of the script
+	Game game(gameBoardSize, Game::defaultAtoms, 0);
+	GameLogWriter log;
+	if (!logFile.empty()) {
+		if (!log.open(logFile, gameBoardSize)) {
+			std::cerr << "cannot write " << logFile << std::endl;
+			device->drop();
+			return 1;
+		}
+		game.record(&log);
+	}
+	GameScript runner(game, std::cout);
+	auto start = std::chrono::steady_clock::now();
+	std::string line;
+	int lineNumber = 0;
+	int status = 0;
+	while (std::getline(script, line)) {
+		++lineNumber;
+		if (!runner.run(line)) {
+			std::cerr << "line " << lineNumber << ": " << runner.error() << std::endl;
+			status = 1;
+			break;
+		}
+		showGame(game, boardNode);
+		// draw a frame for every finished game
+		if (boardNode->takeChanged() && game.evaluated()) {
+			driver->beginScene(true, true, video::SColor(255,150,150,255));
+			smgr->drawAll();
+			driver->endScene();
+		}
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	// final state of the last game
+	runner.printState();
+	std::cerr << runner.games() << " games, " << runner.commands() << " commands in " << elapsed.count() << " s";
+	if (elapsed.count() > 0) {
+		std::cerr << " (" << runner.games() / elapsed.count() << " games/s)";
+	}
+	std::cerr << std::endl;
+	game.record(0);
+	if (!log.close()) {
+		std::cerr << "writing " << logFile << " failed" << std::endl;
+		status = 1;
+	}
+	device->drop();
+	return status;
+}
+
+// play on a volume of size*size*size cells, one layer at a time (mouse wheel or up and down keys)
+// the hint and the ray paths need the flat board, so there are none here
+int runVolume(int volumeSize, int maxFps, bool onDemand, std::uint64_t seed) {
+	MyEventReceiver receiver;
+	IrrlichtDevice *device = createDevice(video::EDT_OPENGL, core::dimension2d<u32>(1024,768), 16, false, false, false, &receiver);
+	if (device == 0) {
+		return 1;
+	}
+	device->setWindowCaption(L"Blackbox");
+	video::IVideoDriver* driver = device->getVideoDriver();
+	scene::ISceneManager* smgr = device->getSceneManager();
+	gui::IGUIEnvironment* guienv = device->getGUIEnvironment();
+	int screenX = driver->getScreenSize().Width;
+	gui::IGUIFont* font = setupGUI(guienv, screenX);
+	guienv->getRootGUIElement()->getElementFromId(GUI_ID_HINT_BUTTON)->setVisible(false);
+	receiver.context.device = device;
+	video::ITexture* example = 0;
+	smgr->setAmbientLight(video::SColorf(1,1,1));
+
+	// a layer looks like the flat board, the panels of the front and back raycubes are beside it
+	scene::SMesh* cube = createBakedMesh(cubeMesh);
+	scene::SMesh* atom = createBakedMesh(atomMesh);
+	const float offset = -(3*volumeSize)/2;
+	VolumeSceneNode* volumeNode = new VolumeSceneNode(smgr->getRootSceneNode(), smgr, volumeSize, offset, cube, atom, cubeColor, raycubeColor, atomColor);
+	volumeNode->drop();
+	VolumePicker picker(volumeSize, offset, cube->getBoundingBox().getExtent().X/2, VolumeSceneNode::layerSpacing(), VolumeSceneNode::panelShift(volumeSize));
+	cube->drop();
+	atom->drop();
+
+	// the same view as on the flat board (up is along X), but from a little below, so the lattice of the
+	// layers behind the current one shows
+	const float distance = volumeCameraDistance(volumeSize);
+	scene::ICameraSceneNode* camera = smgr->addCameraSceneNode(0, core::vector3df(-0.3f*distance,-distance,0),
+		core::vector3df(0,VolumeSceneNode::layerSpacing()*volumeSize/2,0));
+	camera->setUpVector(core::vector3df(1,0,0));
+	scene::ISceneCollisionManager* collmgr = smgr->getSceneCollisionManager();
+
+	Game game(createVolumeBoard(volumeSize), Game::defaultAtoms, seed);
+	Pcg32 colorRng(seed, 1);
+	shuffleAll(colorRng, colors);
+	showGame(game, volumeNode);
+
+	FramePacer pacer(maxFps, onDemand);
+	HudText penaltyText, ratingText, atomsText, layerText;
+	while(device->run() && driver) {
+		bool drawn = false;
+		if (device->isWindowActive()) {
+			if (receiver.context.redraw) {
+				pacer.input();
+				receiver.context.redraw = false;
+			}
+			if (driver->getScreenSize().Width != screenX) {
+				screenX = driver->getScreenSize().Width;
+				layoutGUI(guienv, screenX);
+				pacer.invalidate();
+			}
+			if (receiver.context.decreaseAtoms) {
+				game.fewerAtoms();
+				receiver.context.decreaseAtoms = false;
+			}
+			if (receiver.context.increaseAtoms) {
+				game.moreAtoms();
+				receiver.context.increaseAtoms = false;
+			}
+			if (receiver.context.layerChange) {
+				volumeNode->setLayer(core::clamp(volumeNode->layer() + receiver.context.layerChange, 0, volumeSize-1));
+				receiver.context.layerChange = 0;
+			}
+			if (receiver.context.reset) {
+				game.reset();
+				showGame(game, volumeNode);
+				receiver.context.reset = false;
+			}
+			if (receiver.context.eval) {
+				game.evaluate();
+				showGame(game, volumeNode);
+				receiver.context.eval = false;
+			}
+
+			// the clicks pick on the current layer and its panels
+			InputEvent click;
+			while (receiver.clicks.pop(click)) {
+				bool left = click.button == InputEvent::BUTTON_LEFT;
+				BoardPicker::Pick pick = picker.pick(collmgr->getRayFromScreenCoordinates(core::position2di(click.x, click.y), camera), volumeNode->layer());
+				bool changed = false;
+				if (pick.kind == BoardPicker::PICK_RAYCUBE && left) {
+					changed = game.fire(pick.index);
+				} else if (pick.kind == BoardPicker::PICK_CELL) {
+					changed = left ? game.placeAtom(pick.index) : game.removeAtom(pick.index);
+				}
+				if (changed) {
+					showGame(game, volumeNode);
+				}
+			}
+
+			if (volumeNode->takeChanged()) {
+				pacer.invalidate();
+			}
+			if (!pacer.shouldDraw()) {
+				pacer.wait(false);
+				continue;
+			}
+			driver->beginScene(true, true, video::SColor(255,150,150,255));
+			font->draw(penaltyText.get("Penalty: %d", game.penalty()), core::rect<s32>(screenX/2-90,10,screenX/2+90,50), textcolor);
+			font->draw(layerText.get("Layer: %d/%d", volumeNode->layer()+1, volumeSize), core::rect<s32>(screenX/2-90,60,screenX/2+90,100), textcolor);
+			if (game.evaluated()) {
+				font->draw(ratingText.get("%s", game.rating()), core::rect<s32>(10,60,200,60), textcolor);
+			}
+			if (game.atomsChanged()) {
+				font->draw(atomsText.get("Atoms: %d", game.nextAtoms()), core::rect<s32>(screenX-200,60,screenX-10,60), textcolor);
+			}
+			if (receiver.context.help) {
+				if (!example) {
+					example = getBakedTexture(device, helpImage, "exampleFullhelp.png");
+				}
+				driver->draw2DImage(example, core::position2d<s32>((screenX-790)/2,60));
+			} else {
+				smgr->drawAll();
+			}
+			guienv->drawAll();
+			driver->endScene();
+			pacer.frameDrawn();
+			drawn = true;
+		}
+		pacer.wait(drawn);
+	}
+	device->drop();
+	return 0;
+}
+
+// play several games side by side, the buttons act on all of them and a click on the board it hits
+int runTournament(int boards, int gameBoardSize, int maxFps, bool onDemand, std::uint64_t seed) {
+	MyEventReceiver receiver;
+	IrrlichtDevice *device = createDevice(video::EDT_OPENGL, core::dimension2d<u32>(1024,768), 16, false, false, false, &receiver);
+	if (device == 0) {
+		return 1;
+	}
+	device->setWindowCaption(L"Blackbox");
+	video::IVideoDriver* driver = device->getVideoDriver();
+	scene::ISceneManager* smgr = device->getSceneManager();
+	gui::IGUIEnvironment* guienv = device->getGUIEnvironment();
+	int screenX = driver->getScreenSize().Width;
+	gui::IGUIFont* font = setupGUI(guienv, screenX);
+	guienv->getRootGUIElement()->getElementFromId(GUI_ID_HINT_BUTTON)->setVisible(false);
+	receiver.context.device = device;
+	video::ITexture* example = 0;
+	smgr->setAmbientLight(video::SColorf(1,1,1));
 
-int main() {
-	// initialize random
-	std::srand(std::time(nullptr));
+	// the meshes are loaded once for all boards
+	scene::SMesh* cube = createBakedMesh(cubeMesh);
+	scene::SMesh* atom = createBakedMesh(atomMesh);
+	Tournament tournament(smgr, boards, gameBoardSize, cube, atom, seed);
+	cube->drop();
+	atom->drop();
+	scene::ICameraSceneNode* camera = smgr->addCameraSceneNode(0, core::vector3df(0,-tournament.cameraDistance(),0), core::vector3df(0,0,0));
+	scene::ISceneCollisionManager* collmgr = smgr->getSceneCollisionManager();
+	Pcg32 colorRng(seed, 1);
+	shuffleAll(colorRng, colors);
+
+	FramePacer pacer(maxFps, onDemand);
+	std::vector<HudText> penaltyTexts(boards);
+	HudText atomsText;
+	while(device->run() && driver) {
+		bool drawn = false;
+		if (device->isWindowActive()) {
+			if (receiver.context.redraw) {
+				pacer.input();
+				receiver.context.redraw = false;
+			}
+			if (driver->getScreenSize().Width != screenX) {
+				screenX = driver->getScreenSize().Width;
+				layoutGUI(guienv, screenX);
+				pacer.invalidate();
+			}
+			if (receiver.context.decreaseAtoms) {
+				tournament.fewerAtoms();
+				receiver.context.decreaseAtoms = false;
+			}
+			if (receiver.context.increaseAtoms) {
+				tournament.moreAtoms();
+				receiver.context.increaseAtoms = false;
+			}
+			if (receiver.context.reset) {
+				tournament.resetAll();
+				receiver.context.reset = false;
+			}
+			if (receiver.context.eval) {
+				tournament.evaluateAll();
+				receiver.context.eval = false;
+			}
+			InputEvent click;
+			while (receiver.clicks.pop(click)) {
+				tournament.click(collmgr->getRayFromScreenCoordinates(core::position2di(click.x, click.y), camera), click.button == InputEvent::BUTTON_LEFT);
+			}
+
+			// the boards with work update their games and nodes in parallel
+			if (tournament.update()) {
+				pacer.invalidate();
+			}
+			if (!pacer.shouldDraw()) {
+				pacer.wait(false);
+				continue;
+			}
+			driver->beginScene(true, true, video::SColor(255,150,150,255));
+			if (receiver.context.help) {
+				if (!example) {
+					example = getBakedTexture(device, helpImage, "exampleFullhelp.png");
+				}
+				driver->draw2DImage(example, core::position2d<s32>((screenX-790)/2,60));
+			} else {
+				smgr->drawAll();
+				// the penalty (and rating) of every board above it
+				for (int board = 0; board < boards; ++board) {
+					const Game& game = tournament.game(board);
+					core::vector3df top = tournament.node(board)->getAbsolutePosition() + core::vector3df(3*gameBoardSize/2.0f + 5, 0, 0);
+					core::position2di at = collmgr->getScreenCoordinatesFrom3DPosition(top, camera);
+					font->draw(penaltyTexts[board].get("%d %s", game.penalty(), game.evaluated() ? game.rating() : ""),
+						core::rect<s32>(at.X-100, at.Y-20, at.X+100, at.Y), textcolor, true, true);
+				}
+			}
+			if (tournament.game(0).atomsChanged()) {
+				font->draw(atomsText.get("Atoms: %d", tournament.game(0).nextAtoms()), core::rect<s32>(screenX-200,60,screenX-10,60), textcolor);
+			}
+			guienv->drawAll();
+			driver->endScene();
+			pacer.frameDrawn();
+			drawn = true;
+		}
+		pacer.wait(drawn);
+	}
+	device->drop();
+	return 0;
+}
+
+int main(int argc, char** argv) {
+	// read options
+	int gameBoardSize = 8;
+	int maxFps = 60;
+	bool onDemand = true;
+	std::string headlessScript;
+	std::string traceFile;
+	std::string logFile;
+	bool overlay = false;
+	bool showPaths = false;
+	bool volume = false;
+	int boards = 1;
+	bool seeded = false;
+	std::uint64_t seed = 0;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--size" && i+1 < argc) {
+			gameBoardSize = std::atoi(argv[++i]);
+		} else if (arg == "--fps" && i+1 < argc) {
+			maxFps = std::atoi(argv[++i]);
+		} else if (arg == "--continuous") {
+			onDemand = false;
+		} else if (arg == "--trace" && i+1 < argc) {
+			traceFile = argv[++i];
+		} else if (arg == "--seed" && i+1 < argc) {
+			seed = std::strtoull(argv[++i], 0, 10);
+			seeded = true;
+		} else if (arg == "--log" && i+1 < argc) {
+			logFile = argv[++i];
+		} else if (arg == "--paths") {
+			showPaths = true;
+		} else if (arg == "--volume") {
+			volume = true;
+		} else if (arg == "--boards" && i+1 < argc) {
+			boards = std::atoi(argv[++i]);
+		} else if (arg == "--overlay") {
+			overlay = true;
+		} else if (arg == "--headless" && i+1 < argc) {
+			headlessScript = argv[++i];
+		} else {
+			gameBoardSize = 0;
+		}
+		if (gameBoardSize < 4 || gameBoardSize > (volume ? maxVolumeSize : maxBoardSize) || (volume && !headlessScript.empty()) || boards < 1 || boards > maxBoards) {
+			std::cout << "usage: blackbox [--size n] [--fps max] [--continuous] [--seed n] [--paths] [--volume] [--boards k] [--overlay] [--trace file.json] [--log file] [--headless script]" << std::endl;
+			std::cout << "  --size sets the width of the gameboard (4 to " << maxBoardSize << ", default 8)" << std::endl;
+			std::cout << "  --fps limits the frame rate (0 for no limit, default 60)" << std::endl;
+			std::cout << "  --continuous draws every frame instead of only after changes" << std::endl;
+			std::cout << "  --seed plays the same games and ray colors on every run (random by default)" << std::endl;
+			std::cout << "  --paths draws the path of every fired ray through the board" << std::endl;
+			std::cout << "  --boards plays k games (up to " << maxBoards << ") side by side, without hints, paths and logs" << std::endl;
+			std::cout << "  --volume plays on a cube of size^3 cells (up to " << maxVolumeSize << "), one layer at a time, without hints, paths and logs" << std::endl;
+			std::cout << "  --overlay shows the median and 99th percentile frame time and input latency" << std::endl;
+			std::cout << "  --trace writes the timings of the main loop as chrome trace events" << std::endl;
+			std::cout << "  --log appends every game to a binary game log (see blackbox-stats)" << std::endl;
+			std::cout << "  --headless plays a script (- for stdin) on the null driver without a window" << std::endl;
+			return 1;
+		}
+	}
+	if (!headlessScript.empty()) {
+		return runHeadless(gameBoardSize, headlessScript, logFile);
+	}
+	if (!seeded) {
+		std::random_device seeds;
+		seed = (std::uint64_t(seeds()) << 32) ^ seeds();
+	}
+	if (volume) {
+		return runVolume(gameBoardSize, maxFps, onDemand, seed);
+	}
+	if (boards > 1) {
+		return runTournament(boards, gameBoardSize, maxFps, onDemand, seed);
+	}
 
 	// start up the engine
 	MyEventReceiver receiver;
@@ -202,423 +592,253 @@ int main() {
 
 	// build and configure gui
 	int screenX = driver->getScreenSize().Width;
-	video::SColor textcolor(255,255,255,255);
-	gui::IGUIFont* font = guienv->getFont("../fonts/bigfont.png");
-	if (!font) {
-		std::cout << "font not found" << std::endl;
-		font = guienv->getBuiltInFont();
-	}
-	guienv->getSkin()->setFont(font);
-	guienv->getSkin()->setColor(gui::EGUI_DEFAULT_COLOR::EGDC_BUTTON_TEXT, textcolor);
-	guienv->getSkin()->setColor(gui::EGUI_DEFAULT_COLOR::EGDC_TOOLTIP, textcolor);
-	buildGUI(guienv, screenX);
+	gui::IGUIFont* font = setupGUI(guienv, screenX);
 	receiver.context.device = device;
 
-	// load example image
-	video::ITexture* example = driver->getTexture("../images/exampleFullhelp.png");
+	// example image (loaded the first time help is shown)
+	video::ITexture* example = 0;
 
 	// add light
 	smgr->setAmbientLight(video::SColorf(1,1,1));
 
-	// load the cube
-	scene::IMesh* cube = smgr->getMesh("../models/cube.obj");
-	if (!cube) {
-		device->drop();
-		return 1;
-	}
-
-	// load the atom
-	scene::IMesh* atom = smgr->getMesh("../models/atom.obj");
-	if (!atom) {
-		device->drop();
-		return 1;
-	}
+	// the cube and the atom are compiled into the executable (see blackbox-bake)
+	scene::SMesh* cube = createBakedMesh(cubeMesh);
+	scene::SMesh* atom = createBakedMesh(atomMesh);
 
 	// init constant variables
-	const int gameBoardSize = 8;
 	const int gameBoardTopLeftOffset = -(3*gameBoardSize)/2;
-	const video::SColor cubeColor = video::SColor(255,0,0,128);//255,0,16,156);
-	const video::SColor raycubeColor = video::SColor(255,0,0,0);//video::SColor(255,0,128,0);//255,0,156,5);
-	const video::SColor atomColor = video::SColor(255,255,255,0);
-	const video::SColor reflectedCube = video::SColor(255,255,255,255);
-	// init atom number
-	int maxAtoms = 5;
-
-	// add cubes to the scene to form the gameboard
-	std::vector<std::vector<scene::ISceneNode*>> cubes;
-	std::vector<std::vector<scene::ISceneNode*>> atoms;
-	std::vector<scene::ISceneNode*> leftRaycubes;
-	std::vector<scene::ISceneNode*> rightRaycubes;
-	std::vector<scene::ISceneNode*> topRaycubes;
-	std::vector<scene::ISceneNode*> bottomRaycubes;
-	for (int y = 0; y < gameBoardSize; ++y) {
-		cubes.push_back(std::vector<scene::ISceneNode*>());
-		atoms.push_back(std::vector<scene::ISceneNode*>());
-		for (int x = 0; x < gameBoardSize; ++x) {
-			float cubeScale = cube->getBoundingBox().getExtent().X/2;
-			core::vector3df cubePosition = core::vector3df(gameBoardTopLeftOffset + 3*x + cubeScale, 0, gameBoardTopLeftOffset + 3*y + cubeScale + 0.5);
-			cubes[y].push_back(createNode(driver, smgr, cube, cubePosition, cubeColor, y*gameBoardSize+x));
-			atoms[y].push_back(createNode(driver, smgr, atom, cubePosition + core::vector3df(0,-1,0), atomColor, y*gameBoardSize+x));
-			atoms[y][x]->setVisible(false);
-
-			if (x == 0) {
-				core::vector3df raycubePosition = cubes[y][x]->getPosition() + core::vector3df(-5,0,0);
-				bottomRaycubes.push_back(createNode(driver, smgr, cube, raycubePosition, raycubeColor));
-			}
-			if (y == 0) {
-				core::vector3df raycubePosition = cubes[y][x]->getPosition() + core::vector3df(0,0,-5);
-				leftRaycubes.push_back(createNode(driver, smgr, cube, raycubePosition, raycubeColor));
-			}
-			if (x == gameBoardSize-1) {
-				core::vector3df raycubePosition = cubes[y][x]->getPosition() + core::vector3df(5,0,0);
-				topRaycubes.push_back(createNode(driver, smgr, cube, raycubePosition, raycubeColor));
-			}
-			if (y == gameBoardSize-1) {
-				core::vector3df raycubePosition = cubes[y][x]->getPosition() + core::vector3df(0,0,5);
-				rightRaycubes.push_back(createNode(driver, smgr, cube, raycubePosition, raycubeColor));
-			}
-		}
+
+	// add cubes to the scene to form the gameboard (a single node draws all cubes and atoms)
+	BoardSceneNode* boardNode = new BoardSceneNode(smgr->getRootSceneNode(), smgr, gameBoardSize, gameBoardTopLeftOffset, cube, atom, cubeColor, raycubeColor, atomColor);
+	boardNode->drop();
+
+	// the paths of the fired rays in a single node (only with --paths, they give the atoms away)
+	RayPathNode* pathNode = 0;
+	std::vector<RayPoint> pathCorners;
+	pathCorners.reserve(4*gameBoardSize);
+	if (showPaths) {
+		pathNode = new RayPathNode(smgr->getRootSceneNode(), smgr, boardNode, 12.0f);
+		pathNode->drop();
 	}
-	std::vector<std::vector<scene::ISceneNode*>> raycubes = {leftRaycubes, rightRaycubes, bottomRaycubes, topRaycubes};
 
-	// add a static camera that views the gameboard
-	smgr->addCameraSceneNode(0, core::vector3df(0,-30,0), core::vector3df(0,0,0));
+	// add a static camera that views the gameboard (farther away for larger boards)
+	scene::ICameraSceneNode* camera = smgr->addCameraSceneNode(0, core::vector3df(0,-cameraDistance(gameBoardSize),0), core::vector3df(0,0,0));
 	//device->getCursorControl()->setVisible(true);
 
-	// add collision manager
+	// add collision manager (only used to turn mouse positions into rays, picking is done on the board grid)
 	scene::ISceneCollisionManager* collmgr = smgr->getSceneCollisionManager();
+	BoardPicker picker(gameBoardSize, gameBoardTopLeftOffset, cube->getBoundingBox().getExtent().X/2);
+	cube->drop();
+	atom->drop();
 
 	// get random positions for atoms (defines their placement)
-	std::vector<int> atomPositions;
-	while (atomPositions.size() < maxAtoms) {
-		int newPos = std::rand() % (gameBoardSize*gameBoardSize);
-		if (std::find(atomPositions.begin(), atomPositions.end(), newPos) == atomPositions.end()) {
-			atomPositions.push_back(newPos);
-			//cubes[static_cast<int>(newPos/gameBoardSize)][newPos%gameBoardSize]->getMaterial(0).AmbientColor = video::SColor(255,255,255,255);
-			//std::cout << "atom at: " << newPos << " x: " << static_cast<int>(newPos/gameBoardSize) << " , y: " << newPos%gameBoardSize << std::endl;
+	// (the bitboard behind it is picked by the board size, ray outcomes are traced on their first click only)
+	Game game(gameBoardSize, Game::defaultAtoms, seed);
+	GameLogWriter log;
+	if (!logFile.empty()) {
+		if (log.open(logFile, gameBoardSize)) {
+			game.record(&log);
+		} else {
+			std::cout << "cannot write " << logFile << std::endl;
 		}
 	}
 
-	// shuffle colors
-	std::shuffle(colors.begin(), colors.end(), std::default_random_engine{});
+	// shuffle colors (from a stream of the seed of their own, so they do not change the atoms)
+	Pcg32 colorRng(seed, 1);
+	shuffleAll(colorRng, colors);
+
+	// recommends the next ray in the background while the hint is shown (from a stream of the seed of its own too)
+	std::unique_ptr<HintEngine> hints = createHintEngine(gameBoardSize, seed);
+
+	// the game runs on a thread of its own, the loop below posts the input and shows the newest snapshot
+	GameThread gameThread(game, hints.get(), pathNode != 0);
+	GameSnapshot snapshot;
+	bool hintShown = false;
+	// the game the shown paths belong to and how many of them are shown
+	std::uint64_t pathGame = 0;
+	std::size_t pathsShown = 0;
 
 	// init remaining required variables
-	int atomsSet = 0;
-	int penalty = 0;
-	std::vector<video::SColor> raycolors(colors);
-	bool feedback, atomsChanged = false;
-	int nextMaxAtoms = maxAtoms;
+	FramePacer pacer(maxFps, onDemand);
+	FrameProfiler profiler;
+	HudText penaltyText, ratingText, atomsText, hintText, timingText;
+	// frames that allocated on the heap after the first ones (which fill caches and buffers)
+	const int warmupFrames = 100;
+	int framesDrawn = 0;
+	int allocatingFrames = 0;
+	std::uint64_t frameAllocations = 0;
+	if (!traceFile.empty() && !profiler.openTrace(traceFile)) {
+		std::cout << "cannot write " << traceFile << std::endl;
+	}
 
 	// run
 	while(device->run() && driver) {
+		bool drawn = false;
 		if (device->isWindowActive()) {
-			driver->beginScene(true, true, video::SColor(255,150,150,255));
+			profiler.beginFrame();
+			std::uint64_t allocationsBefore = allocationCount();
+			{
+				FrameProfiler::Scope scope(profiler, PHASE_INPUT);
+				if (receiver.context.redraw) {
+					pacer.input();
+					receiver.context.redraw = false;
+				}
 
-			// check for resized window
-			if (driver->getScreenSize().Width != screenX) {
-				screenX = driver->getScreenSize().Width;
-				guienv->clear();
-				buildGUI(guienv, screenX);
-			}
+				// check for resized window
+				if (driver->getScreenSize().Width != screenX) {
+					screenX = driver->getScreenSize().Width;
+					layoutGUI(guienv, screenX);
+					pacer.invalidate();
+				}
 
-			// check for more or less atoms wanted
-			if (receiver.context.decreaseAtoms) {
-				if (nextMaxAtoms > 3) {
-					--nextMaxAtoms;
-					atomsChanged = true;
+				// check for more or less atoms wanted, reset, eval and the hint
+				if (receiver.context.decreaseAtoms) {
+					gameThread.post(GameThread::CMD_FEWER_ATOMS);
 					receiver.context.decreaseAtoms = false;
 				}
-			}
-			if (receiver.context.increaseAtoms) {
-				if (nextMaxAtoms < gameBoardSize*2) {
-					++nextMaxAtoms;
-					atomsChanged = true;
+				if (receiver.context.increaseAtoms) {
+					gameThread.post(GameThread::CMD_MORE_ATOMS);
 					receiver.context.increaseAtoms = false;
 				}
-			}
-
-			// check for reset
-			if (receiver.context.reset) {
-				atomsSet = 0;
-				penalty = 0;
-				raycolors = colors;
-				maxAtoms = nextMaxAtoms;
-				for (int y = 0; y < gameBoardSize; ++y) {
-					for (int x = 0; x < gameBoardSize; ++x) {
-						cubes[y][x]->getMaterial(0).AmbientColor = cubeColor;
-						atoms[y][x]->setVisible(false);
-					}
+				if (receiver.context.reset) {
+					gameThread.post(GameThread::CMD_RESET);
+					receiver.context.reset = false;
 				}
-				for (auto & vec : raycubes) {
-					for (auto & cube : vec) {
-						cube->getMaterial(0).AmbientColor = raycubeColor;
-					}
+				if (receiver.context.eval) {
+					gameThread.post(GameThread::CMD_EVALUATE);
+					receiver.context.eval = false;
 				}
-				atomPositions.clear();
-				while (atomPositions.size() < maxAtoms) {
-					int newPos = std::rand() % (gameBoardSize*gameBoardSize);
-					if (std::find(atomPositions.begin(), atomPositions.end(), newPos) == atomPositions.end()) {
-						atomPositions.push_back(newPos);
-						//cubes[static_cast<int>(newPos/gameBoardSize)][newPos%gameBoardSize]->getMaterial(0).AmbientColor = video::SColor(255,255,255,255);
-						//std::cout << "atom at: " << newPos << " x: " << static_cast<int>(newPos/gameBoardSize) << " , y: " << newPos%gameBoardSize << std::endl;
-					}
+				if (receiver.context.hint != hintShown) {
+					hintShown = receiver.context.hint;
+					gameThread.post(hintShown ? GameThread::CMD_HINT_ON : GameThread::CMD_HINT_OFF);
 				}
-				atomsChanged = false;
-				feedback = false;
-				receiver.context.reset = false;
-				continue;
 			}
 
-			// check eval
-			if (receiver.context.eval) {
-				for (auto & pos : atomPositions) {
-					if (!atoms[static_cast<int>(pos/gameBoardSize)][pos%gameBoardSize]->isVisible()) {
-						penalty += 5;
-						cubes[static_cast<int>(pos/gameBoardSize)][pos%gameBoardSize]->getMaterial(0).AmbientColor = video::SColor(255,255,0,0);
-					} else {
-						cubes[static_cast<int>(pos/gameBoardSize)][pos%gameBoardSize]->getMaterial(0).AmbientColor = video::SColor(255,0,255,0);
-					}
+			// handle the mouse clicks since the last iteration (not gui), a held button only counts once
+			InputEvent click;
+			while (receiver.clicks.pop(click)) {
+				bool left = click.button == InputEvent::BUTTON_LEFT;
+
+				// find the cube below the mouse on the board plane
+				BoardPicker::Pick pick;
+				{
+					FrameProfiler::Scope scope(profiler, PHASE_PICK);
+					pick = picker.pick(collmgr->getRayFromScreenCoordinates(core::position2di(click.x, click.y), camera));
+				}
+
+				// react on mouse clicks depending on the node type clicked: fire the raycube,
+				// set or remove the atom of an inner gameboard cube (the game thread does the rest)
+				if (pick.kind == BoardPicker::PICK_RAYCUBE && left) {
+					gameThread.post(GameThread::CMD_FIRE, pick.index, click.time);
+				} else if (pick.kind == BoardPicker::PICK_CELL) {
+					gameThread.post(left ? GameThread::CMD_PLACE : GameThread::CMD_REMOVE, pick.index, click.time);
+				} else {
+					// a miss is on screen with the next drawn frame
+					profiler.inputHandled(click.time);
 				}
-				feedback = true;
-				receiver.context.eval = false;
 			}
 
-			// check for a mouse click (not gui)
-			core::position2d<s32> position;
-			if (receiver.mouseState.leftButtonDown || receiver.mouseState.rightButtonDown) {
-				position = receiver.mouseState.pos;
-
-				// check collision of the mouse click with a scene node
-				scene::ISceneNode * selectedSceneNode = collmgr->getSceneNodeFromScreenCoordinatesBB(position);
-
-				// react on mouse clicks depending on the node type clicked
-				if (selectedSceneNode) {
-					// if a raycube is clicked, check at which position it is in the vector
-					int raycubeHit = -1;
-					std::vector<scene::ISceneNode*>::iterator it;
-					int index;
-					for (int i = 0; i < raycubes.size(); ++i) {
-						it = std::find(raycubes[i].begin(), raycubes[i].end(), selectedSceneNode);
-						if (it != raycubes[i].end()) {
-							raycubeHit = i;
-							index = distance(raycubes[i].begin(), it);
-							break;
-						}
+			// show the newest state of the game (the paths of the new rays grow from their raycubes)
+			if (gameThread.latest(snapshot)) {
+				FrameProfiler::Scope scope(profiler, PHASE_SNAPSHOT);
+				showSnapshot(snapshot, boardNode);
+				if (pathNode) {
+					if (snapshot.game != pathGame) {
+						pathNode->clear();
+						pathGame = snapshot.game;
+						pathsShown = 0;
 					}
-
-					// if a raycube is selected, run game logic
-					if (raycubeHit > -1 && selectedSceneNode->getMaterial(0).AmbientColor == raycubeColor) {
-						// each raycube clicked costs a point
-						++penalty;
-						// init variables dependent on the raycube clicked
-						if (receiver.mouseState.leftButtonDown) {
-							//std::cout << "array containing clicked raycube: " << raycubeHit << " index: " << index << std::endl;
-							bool horizontal;
-							int incrementor;
-							int x = 0;
-							int y = 0;
-							if (raycubeHit == 0) { // leftRaycubes
-								horizontal = true;
-								incrementor = 1;
-								y = index;
-							}
-							if (raycubeHit == 1) { // rightRaycubes
-								horizontal = true;
-								incrementor = -1;
-								x = gameBoardSize-1;
-								y = index;
-							}
-							if (raycubeHit == 2) { // bottomRaycubes
-								horizontal = false;
-								incrementor = 1;
-								x = index;
-							}
-							if (raycubeHit == 3) { // topRaycubes
-								horizontal = false;
-								incrementor = -1;
-								y = gameBoardSize-1;
-								x = index;
-							}
-
-							// if atom left or right of straight path: if step==0: lighten current (reflect)
-							if ((horizontal && y < gameBoardSize-1
-							&& std::find(atomPositions.begin(), atomPositions.end(), cubes[x][y+1]->getID()) != atomPositions.end())
-							|| (horizontal && y > 0
-							&& std::find(atomPositions.begin(), atomPositions.end(), cubes[x][y-1]->getID()) != atomPositions.end())
-							|| (!horizontal && x < gameBoardSize-1
-							&& std::find(atomPositions.begin(), atomPositions.end(), cubes[x+1][y]->getID()) != atomPositions.end())
-							|| (!horizontal && x > 0
-							&& std::find(atomPositions.begin(), atomPositions.end(), cubes[x-1][y]->getID()) != atomPositions.end())) {
-								//std::cout << "atom next to ray step 0" << std::endl;
-								raycubes[raycubeHit][index]->getMaterial(0).AmbientColor = reflectedCube;
-							} else {
-								// shoot ray
-								while (true) {
-									// if raycube reached: color raycube
-									if (x >= gameBoardSize || x < 0 || y >= gameBoardSize || y < 0) {
-										//std::cout << "border reached at x: " << x << " y: " << y << " index: " << index << " raycubeHit: " << raycubeHit << std::endl;
-										raycubes[raycubeHit][index]->getMaterial(0).AmbientColor = raycolors.back();
-										if (x < 0) {
-											if (raycubeHit == 0 && index == y) { // if reflected back to the clicked raycube
-												raycubes[raycubeHit][index]->getMaterial(0).AmbientColor = reflectedCube;
-												break;
-											}
-											raycubes[0][y]->getMaterial(0).AmbientColor = raycolors.back();
-										}
-										if (x >= gameBoardSize) {
-											if (raycubeHit == 1 && index == y) { // if reflected back to the clicked raycube
-												raycubes[raycubeHit][index]->getMaterial(0).AmbientColor = reflectedCube;
-												break;
-											}
-											raycubes[1][y]->getMaterial(0).AmbientColor = raycolors.back();
-										}
-										if (y < 0) {
-											if (raycubeHit == 2 && index == x) { // if reflected back to the clicked raycube
-												raycubes[raycubeHit][index]->getMaterial(0).AmbientColor = reflectedCube;
-												break;
-											}
-											raycubes[2][x]->getMaterial(0).AmbientColor = raycolors.back();
-										}
-										if (y >= gameBoardSize) {
-											if (raycubeHit == 3 && index == x) { // if reflected back to the clicked raycube
-												raycubes[raycubeHit][index]->getMaterial(0).AmbientColor = reflectedCube;
-												break;
-											}
-											raycubes[3][x]->getMaterial(0).AmbientColor = raycolors.back();
-										}
-										raycolors.pop_back();
-										break;
-									}
-									// if atom in straight path: color current (hit)
-									if (std::find(atomPositions.begin(), atomPositions.end(), cubes[x][y]->getID()) != atomPositions.end()) {
-										//std::cout << "atom hit" << std::endl;
-										raycubes[raycubeHit][index]->getMaterial(0).AmbientColor = raycolors.back();
-										raycolors.pop_back();
-										break;
-									}
-									// if atom left or right of straight path: if step!=0: change path away from atom (deflect)
-									if (horizontal && y < gameBoardSize-1
-									&& std::find(atomPositions.begin(), atomPositions.end(), cubes[x][y+1]->getID()) != atomPositions.end()) {
-										if (horizontal && y > 0
-										&& std::find(atomPositions.begin(), atomPositions.end(), cubes[x][y-1]->getID()) != atomPositions.end()) {
-											//std::cout << "double deflection on horizontal path" << std::endl;
-											x -= incrementor;
-											incrementor *= -1;
-											continue;
-										}
-										horizontal = !horizontal;
-										x -= incrementor;
-										incrementor = -1;
-									}
-									if (horizontal && y > 0
-									&& std::find(atomPositions.begin(), atomPositions.end(), cubes[x][y-1]->getID()) != atomPositions.end()) {
-										if (horizontal && y < gameBoardSize-1
-										&& std::find(atomPositions.begin(), atomPositions.end(), cubes[x][y+1]->getID()) != atomPositions.end()) {
-											//std::cout << "double deflection on horizontal path" << std::endl;
-											x -= incrementor;
-											incrementor *= -1;
-											continue;
-										}
-										//std::cout << "deflected on horizontal path" << std::endl;
-										horizontal = !horizontal;
-										x -= incrementor;
-										incrementor = 1;
-									}
-									if (!horizontal && x < gameBoardSize-1
-									&& std::find(atomPositions.begin(), atomPositions.end(), cubes[x+1][y]->getID()) != atomPositions.end()) {
-										if (!horizontal && x > 0
-										&& std::find(atomPositions.begin(), atomPositions.end(), cubes[x-1][y]->getID()) != atomPositions.end()) {
-											//std::cout << "double deflection on vertical path" << std::endl;
-											y -= incrementor;
-											incrementor *= -1;
-											continue;
-										}
-										horizontal = !horizontal;
-										y -= incrementor;
-										incrementor = -1;
-									}
-									if (!horizontal && x > 0
-									&& std::find(atomPositions.begin(), atomPositions.end(), cubes[x-1][y]->getID()) != atomPositions.end()) {
-										if (!horizontal && x < gameBoardSize-1
-										&& std::find(atomPositions.begin(), atomPositions.end(), cubes[x+1][y]->getID()) != atomPositions.end()) {
-											//std::cout << "double deflection on vertical path" << std::endl;
-											y -= incrementor;
-											incrementor *= -1;
-											continue;
-										}
-										//std::cout << "deflected on vertical path" << std::endl;
-										horizontal = !horizontal;
-										y -= incrementor;
-										incrementor = 1;
-									}
-									// next step of ray
-									if (horizontal) {
-										x = x + incrementor;
-									}
-									if (!horizontal) {
-										y = y + incrementor;
-									}
-								}
-							}
-						}
-					} else {
-						// if an inner gameboard cube (or an atom) is selected, set or remove the respective atom (if atoms are left)
-						if (selectedSceneNode->getID() > -1) {
-							scene::ISceneNode * selectedAtomCube = atoms[static_cast<int>(selectedSceneNode->getID()/gameBoardSize)][selectedSceneNode->getID()%gameBoardSize];
-							if (!selectedAtomCube->isVisible() && receiver.mouseState.leftButtonDown && atomsSet < maxAtoms) {
-								selectedAtomCube->setVisible(true);
-								++atomsSet;
-							} else if (selectedAtomCube->isVisible() && receiver.mouseState.rightButtonDown) {
-								selectedAtomCube->setVisible(false);
-								--atomsSet;
-							}
-						}
+					for (; pathsShown < snapshot.pathEnds.size(); ++pathsShown) {
+						int begin = pathsShown ? snapshot.pathEnds[pathsShown-1] : 0;
+						pathCorners.assign(snapshot.pathCorners.begin() + begin, snapshot.pathCorners.begin() + snapshot.pathEnds[pathsShown]);
+						pathNode->addPath(pathCorners, rayColor(snapshot.raycubes[snapshot.pathEntries[pathsShown]]));
 					}
-					//std::cout << "cube id: " << selectedSceneNode->getID() << std::endl;
-					//std::cout << "atoms set: " << atomsSet << std::endl;
 				}
+				// the clicks in it are on screen with the next drawn frame
+				for (const auto & time : snapshot.inputs) {
+					profiler.inputHandled(time);
+				}
+				// the text changes without the board
+				pacer.invalidate();
 			}
 
+			// only draw if something changed (or always in continuous mode)
+			if (boardNode->takeChanged()) {
+				pacer.invalidate();
+			}
+			// a growing path needs every frame until it is complete
+			if (pathNode && (pathNode->takeChanged() || pathNode->animating())) {
+				pacer.invalidate();
+			}
+			if (!pacer.shouldDraw()) {
+				pacer.wait(false);
+				continue;
+			}
+			driver->beginScene(true, true, video::SColor(255,150,150,255));
+
 			// show points
 			if (font) {
-				std::stringstream ss;
-				ss << "Penalty: " << penalty;
-				std::string s = ss.str();
-				font->draw(s.c_str(), core::rect<s32>(screenX/2-90,10,screenX/2+90,50), textcolor);
-				if (feedback) {
-					std::string fb;
-					if (penalty == gameBoardSize) {
-						fb = "Perfect!";
-					} else if (penalty == gameBoardSize) {
-						fb = "Awesome!";
-					} else if (penalty < gameBoardSize*2) {
-						fb = "Well done!";
-					} else if (penalty > gameBoardSize*4) {
-						fb = "Better luck next time!";
-					} else if (penalty > gameBoardSize*3) {
-						fb = "Getting there!";
-					} else {
-						fb = "Nice!";
-					}
-					font->draw(fb.c_str(), core::rect<s32>(10,60,200,60), textcolor);
+				FrameProfiler::Scope scope(profiler, PHASE_TEXT);
+				font->draw(penaltyText.get("Penalty: %d", snapshot.penalty), core::rect<s32>(screenX/2-90,10,screenX/2+90,50), textcolor);
+				if (snapshot.evaluated) {
+					font->draw(ratingText.get("%s", snapshot.rating), core::rect<s32>(10,60,200,60), textcolor);
+				}
+				if (snapshot.atomsChanged) {
+					font->draw(atomsText.get("Atoms: %d", snapshot.nextAtoms), core::rect<s32>(screenX-200,60,screenX-10,60), textcolor);
+				}
+				if (receiver.context.hint && snapshot.hintEntry >= 0) {
+					font->draw(hintText.get("Hint: %c%d (%.1f bits)", "LRBT"[snapshot.hintEntry/gameBoardSize], snapshot.hintEntry%gameBoardSize, snapshot.hintGain),
+						core::rect<s32>(screenX/2-90,60,screenX/2+90,100), textcolor);
 				}
-				if (atomsChanged) {
-					std::stringstream ss;
-					ss << "Atoms: " << nextMaxAtoms;
-					std::string s = ss.str();
-					font->draw(s.c_str(), core::rect<s32>(screenX-200,60,screenX-10,60), textcolor);
+				if (overlay) {
+					// frame times up to the previous frame and the time from a click to the frame showing it
+					s32 screenY = driver->getScreenSize().Height;
+					font->draw(timingText.get("frame %.2f/%.2f ms, input %.2f/%.2f ms (p50/p99)", profiler.percentile(0.5), profiler.percentile(0.99),
+						profiler.latencyPercentile(0.5), profiler.latencyPercentile(0.99)),
+						core::rect<s32>(10,screenY-50,screenX-10,screenY-10), textcolor);
 				}
 			}
 
 			// draw scene (or help if called) and gui
-			if (receiver.context.help) {
-				driver->draw2DImage(example, core::position2d<s32>((screenX-790)/2,60));
-			} else {
-				smgr->drawAll();
+			{
+				FrameProfiler::Scope scope(profiler, PHASE_SCENE);
+				if (receiver.context.help) {
+					if (!example) {
+						example = getBakedTexture(device, helpImage, "exampleFullhelp.png");
+					}
+					driver->draw2DImage(example, core::position2d<s32>((screenX-790)/2,60));
+				} else {
+					smgr->drawAll();
+				}
+			}
+			{
+				FrameProfiler::Scope scope(profiler, PHASE_GUI);
+				guienv->drawAll();
+			}
+			{
+				FrameProfiler::Scope scope(profiler, PHASE_END_SCENE);
+				driver->endScene();
+			}
+			profiler.frameDrawn();
+			pacer.frameDrawn();
+			drawn = true;
+			if (++framesDrawn > warmupFrames && allocationCount() != allocationsBefore) {
+				++allocatingFrames;
+				frameAllocations += allocationCount() - allocationsBefore;
 			}
-			guienv->drawAll();
-			driver->endScene();
 		}
+		pacer.wait(drawn);
+	}
+
+#ifdef BLACKBOX_COUNT_ALLOCATIONS
+	std::cout << allocatingFrames << " of " << std::max(0, framesDrawn-warmupFrames) << " frames allocated (" << frameAllocations << " allocations)" << std::endl;
+#endif
+
+	// write the last game (once the game thread is done with it)
+	gameThread.stop();
+	game.record(0);
+	if (!log.close()) {
+		std::cout << "writing " << logFile << " failed" << std::endl;
 	}
 
 	// delete the device
@@ -0,0 +1,109 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "notation.h"
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+const char sideNames[] = {'L', 'R', 'B', 'T'};
+}
+
+std::string entryName(int entry, int size) {
+	return sideNames[entry/size] + std::to_string(entry%size);
+}
+
+int parseEntry(const std::string& name, int size) {
+	return parseEntry(name.c_str(), size);
+}
+
+int parseEntry(const char* name, int size) {
+	if (name[0] == '\0' || name[1] == '\0') {
+		return -1;
+	}
+	int side = 0;
+	while (side < 4 && sideNames[side] != name[0]) {
+		++side;
+	}
+	char* end;
+	long index = std::strtol(name+1, &end, 10);
+	if (side == 4 || *end != '\0' || index < 0 || index >= size) {
+		return -1;
+	}
+	return side*size + index;
+}
+
+std::string resultName(const RayResult& result, int size) {
+	switch (result.outcome) {
+		case RAY_HIT:
+			return "hit";
+		case RAY_REFLECTION:
+			return "reflection";
+		default:
+			return entryName(result.exit, size);
+	}
+}
+
+int writeResultName(char* out, int capacity, const RayResult& result, int size) {
+	switch (result.outcome) {
+		case RAY_HIT:
+			return std::snprintf(out, capacity, "hit");
+		case RAY_REFLECTION:
+			return std::snprintf(out, capacity, "reflection");
+		default:
+			return std::snprintf(out, capacity, "%c%d", sideNames[result.exit/size], result.exit%size);
+	}
+}
+
+bool parseResult(const std::string& name, int size, RayResult& result) {
+	if (name == "hit") {
+		result = RayResult(RAY_HIT);
+		return true;
+	}
+	if (name == "reflection") {
+		result = RayResult(RAY_REFLECTION);
+		return true;
+	}
+	int exit = parseEntry(name, size);
+	if (exit < 0) {
+		return false;
+	}
+	result = RayResult(RAY_EXIT, exit);
+	return true;
+}
+
+std::string cellName(int cell, int size) {
+	return std::to_string(cell/size) + "," + std::to_string(cell%size);
+}
+
+int parseCell(const std::string& name, int size) {
+	return parseCell(name.c_str(), size);
+}
+
+int parseCell(const char* name, int size) {
+	char* end;
+	long x = std::strtol(name, &end, 10);
+	if (end == name || *end != ',') {
+		return -1;
+	}
+	const char* rest = end+1;
+	long y = std::strtol(rest, &end, 10);
+	if (end == rest || *end != '\0' || x < 0 || x >= size || y < 0 || y >= size) {
+		return -1;
+	}
+	return x*size + y;
+}
@@ -0,0 +1,42 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BLACKBOX_NOTATION_H
+#define BLACKBOX_NOTATION_H
+
+#include "rayengine.h"
+#include <string>
+
+// raycubes are written as their side (L, R, B or T) followed by their index, e.g. "L3"
+std::string entryName(int entry, int size);
+// returns -1 for names that are no raycube of a board of the given size
+int parseEntry(const std::string& name, int size);
+int parseEntry(const char* name, int size);
+
+// outcomes are written as "hit", "reflection" or the name of the raycube the ray left through
+std::string resultName(const RayResult& result, int size);
+bool parseResult(const std::string& name, int size, RayResult& result);
+// the same as resultName written into a buffer without allocating, returns the length like snprintf
+int writeResultName(char* out, int capacity, const RayResult& result, int size);
+
+// cells are written as their x and y coordinate, e.g. "3,4" for the cell id 3*size+4
+std::string cellName(int cell, int size);
+// returns -1 for names that are no cell of a board of the given size
+int parseCell(const std::string& name, int size);
+int parseCell(const char* name, int size);
+
+#endif
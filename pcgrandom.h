@@ -0,0 +1,115 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BLACKBOX_PCGRANDOM_H
+#define BLACKBOX_PCGRANDOM_H
+
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+// the PCG32 generator (XSH RR variant, see https://www.pcg-random.org)
+// the stream picks one of 2^63 independent sequences for the same seed, so threads or boards can
+// each get their own generator from one seed without sharing any state
+// the results do not depend on the standard library, so a seed gives the same games everywhere
+class Pcg32 {
+public:
+	typedef std::uint32_t result_type;
+
+	explicit Pcg32(std::uint64_t seed = 0, std::uint64_t stream = 0) {
+		this->seed(seed, stream);
+	}
+
+	void seed(std::uint64_t seed, std::uint64_t stream = 0) {
+		increment = (stream << 1) | 1;
+		state = 0;
+		(*this)();
+		state += seed;
+		(*this)();
+	}
+
+	static constexpr result_type min() {
+		return 0;
+	}
+
+	static constexpr result_type max() {
+		return 0xffffffffu;
+	}
+
+	result_type operator()() {
+		std::uint64_t old = state;
+		state = old*6364136223846793005ull + increment;
+		std::uint32_t shifted = ((old >> 18) ^ old) >> 27;
+		std::uint32_t rotation = old >> 59;
+		return (shifted >> rotation) | (shifted << ((32 - rotation) & 31));
+	}
+
+	// uniform in 0..bound-1 (multiply and reject instead of std::uniform_int_distribution,
+	// whose results differ between standard libraries)
+	std::uint32_t below(std::uint32_t bound) {
+		std::uint64_t product = std::uint64_t((*this)()) * bound;
+		std::uint32_t low = product;
+		if (low < bound) {
+			std::uint32_t threshold = (0u - bound) % bound;
+			while (low < threshold) {
+				product = std::uint64_t((*this)()) * bound;
+				low = product;
+			}
+		}
+		return product >> 32;
+	}
+
+private:
+	std::uint64_t state;
+	std::uint64_t increment;
+};
+
+// moves count distinct random cells to the front of order with a partial Fisher-Yates shuffle,
+// so atoms are drawn without rejection (order holds any permutation of the cells)
+inline void sampleCells(Pcg32& rng, std::vector<int>& order, int count) {
+	const int cells = order.size();
+	for (int i = 0; i < count; ++i) {
+		std::swap(order[i], order[i + rng.below(cells - i)]);
+	}
+}
+
+// the cells 0..cells-1 in ascending order, the start of every reproducible sample
+inline void resetCells(std::vector<int>& order, int cells) {
+	order.resize(cells);
+	std::iota(order.begin(), order.end(), 0);
+}
+
+// sets a random board of the given number of atoms (any bitboard with clear and set)
+template <class Bits>
+void randomAtoms(Pcg32& rng, std::vector<int>& order, int atoms, Bits& bits) {
+	sampleCells(rng, order, atoms);
+	bits.clear();
+	for (int i = 0; i < atoms; ++i) {
+		bits.set(order[i]);
+	}
+}
+
+// shuffles all elements, the same for a seed everywhere (unlike std::shuffle)
+template <class T>
+void shuffleAll(Pcg32& rng, std::vector<T>& elements) {
+	for (std::size_t i = elements.size(); i > 1; --i) {
+		std::swap(elements[i-1], elements[rng.below(i)]);
+	}
+}
+
+#endif
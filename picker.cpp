@@ -0,0 +1,108 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "picker.h"
+#include <cmath>
+
+using namespace irr;
+
+namespace {
+// distance between neighbouring cubes and between the border cubes and their raycubes
+const float cubeSpacing = 3;
+const float raycubeDistance = 5;
+
+// index of the cube covering the coordinate along one axis of the grid, -1 if it falls into a gap
+int cubeIndex(float coordinate, float cubeWidth) {
+	float slot = std::floor(coordinate / cubeSpacing);
+	if (coordinate - slot*cubeSpacing > cubeWidth) {
+		return -1;
+	}
+	return static_cast<int>(slot);
+}
+}
+
+BoardPicker::BoardPicker(int size, float offset, float cubeScale): size(size), offset(offset), cubeScale(cubeScale) {
+}
+
+BoardPicker::Pick BoardPicker::pick(const core::line3df& ray) const {
+	// the camera looks along y, the cubes face it at y = -cubeScale
+	core::vector3df direction = ray.getVector();
+	if (direction.Y == 0) {
+		return Pick();
+	}
+	float t = (-cubeScale - ray.start.Y) / direction.Y;
+	if (t < 0) {
+		return Pick();
+	}
+	// position relative to the first cube, x runs along X and y along Z just like the cube positions
+	float a = ray.start.X + t*direction.X - offset;
+	float b = ray.start.Z + t*direction.Z - offset - 0.5f;
+	const float width = 2*cubeScale;
+	const float last = cubeSpacing*(size-1);
+
+	int x = cubeIndex(a, width);
+	int y = cubeIndex(b, width);
+	if (x >= 0 && x < size && y >= 0 && y < size) {
+		return Pick(PICK_CELL, y*size+x);
+	}
+	// the raycubes lie raycubeDistance outside of the border cubes
+	if (x >= 0 && x < size) {
+		if (b >= -raycubeDistance && b <= -raycubeDistance+width) {
+			return Pick(PICK_RAYCUBE, 0*size+x);
+		}
+		if (b >= last+raycubeDistance && b <= last+raycubeDistance+width) {
+			return Pick(PICK_RAYCUBE, 1*size+x);
+		}
+	}
+	if (y >= 0 && y < size) {
+		if (a >= -raycubeDistance && a <= -raycubeDistance+width) {
+			return Pick(PICK_RAYCUBE, 2*size+y);
+		}
+		if (a >= last+raycubeDistance && a <= last+raycubeDistance+width) {
+			return Pick(PICK_RAYCUBE, 3*size+y);
+		}
+	}
+	return Pick();
+}
+
+VolumePicker::VolumePicker(int size, float offset, float cubeScale, float layerSpacing, float panelShift):
+	board(size, offset, cubeScale), size(size), layerSpacing(layerSpacing), panelShift(panelShift) {
+}
+
+BoardPicker::Pick VolumePicker::pick(const core::line3df& ray, int layer) const {
+	// move the ray instead of the layer, a volume cell is (x*size+y)*size+z
+	const core::vector3df depth(0, layerSpacing*layer, 0);
+	BoardPicker::Pick pick = board.pick(core::line3df(ray.start - depth, ray.end - depth));
+	if (pick.kind == BoardPicker::PICK_CELL) {
+		return BoardPicker::Pick(BoardPicker::PICK_CELL, pick.index*size + layer);
+	}
+	if (pick.kind == BoardPicker::PICK_RAYCUBE) {
+		// the sides of the flat board are the first four faces, their index is a*size+z
+		int side = pick.index / size;
+		int index = pick.index % size;
+		return BoardPicker::Pick(BoardPicker::PICK_RAYCUBE, (side*size + index)*size + layer);
+	}
+	// a panel cube shoots along z through the cell at the same place on the board
+	for (int panel = 0; panel < 2; ++panel) {
+		const core::vector3df shift = depth + core::vector3df(0,0, panel == 0 ? -panelShift : panelShift);
+		pick = board.pick(core::line3df(ray.start - shift, ray.end - shift));
+		if (pick.kind == BoardPicker::PICK_CELL) {
+			return BoardPicker::Pick(BoardPicker::PICK_RAYCUBE, (4+panel)*size*size + pick.index);
+		}
+	}
+	return BoardPicker::Pick();
+}
@@ -0,0 +1,67 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BLACKBOX_PICKER_H
+#define BLACKBOX_PICKER_H
+
+#include <irrlicht.h>
+
+// maps mouse rays to gameboard cubes and raycubes by intersecting them with the board plane,
+// the board is a regular grid, so this does not need to look at any scene node
+class BoardPicker {
+public:
+	enum Kind {
+		PICK_NONE = 0,
+		PICK_CELL,		// index is the id of the gameboard cube (y*size+x)
+		PICK_RAYCUBE	// index is the entry id of the raycube (side*size+index)
+	};
+
+	struct Pick {
+		Kind kind;
+		int index;
+		Pick(Kind kind = PICK_NONE, int index = -1): kind(kind), index(index) {}
+	};
+
+	// offset is the position of the lower left corner of the board, cubeScale half the cube width
+	BoardPicker(int size, float offset, float cubeScale);
+
+	Pick pick(const irr::core::line3df& ray) const;
+
+private:
+	int size;
+	float offset;
+	float cubeScale;
+};
+
+// picks on the current layer of a volume (see VolumeSceneNode): its cells and side raycubes like a flat
+// board moved back to the layer, the raycubes of the front and back faces on the panels beside it
+class VolumePicker {
+public:
+	// offset and cubeScale like the flat board, layerSpacing and panelShift like the volume node
+	VolumePicker(int size, float offset, float cubeScale, float layerSpacing, float panelShift);
+
+	// PICK_CELL with the volume cell id, PICK_RAYCUBE with the volume entry id
+	BoardPicker::Pick pick(const irr::core::line3df& ray, int layer) const;
+
+private:
+	BoardPicker board;
+	int size;
+	float layerSpacing;
+	float panelShift;
+};
+
+#endif
@@ -0,0 +1,92 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "puzzlefile.h"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+PuzzleFileHeader puzzleFileHeader(int size, int atoms, int words) {
+	PuzzleFileHeader header;
+	std::memcpy(header.magic, "BBPZ", 4);
+	header.version = puzzleFileVersion;
+	header.size = size;
+	header.atoms = atoms;
+	header.words = words;
+	header.recordSize = (8*words + 4*size + 7) & ~7;
+	return header;
+}
+
+bool PuzzleWriter::open(const std::string& path, int size, int atoms, int words) {
+	close();
+	header = puzzleFileHeader(size, atoms, words);
+	file = path == "-" ? stdout : std::fopen(path.c_str(), "wb");
+	if (!file) {
+		return false;
+	}
+	return std::fwrite(&header, sizeof(header), 1, file) == 1;
+}
+
+bool PuzzleWriter::write(const std::uint8_t* records, std::size_t count) {
+	return std::fwrite(records, header.recordSize, count, file) == count;
+}
+
+bool PuzzleWriter::close() {
+	if (!file) {
+		return true;
+	}
+	bool ok = file == stdout ? std::fflush(file) == 0 : std::fclose(file) == 0;
+	file = 0;
+	return ok;
+}
+
+bool PuzzleBank::open(const std::string& path) {
+	close();
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(PuzzleFileHeader))) {
+		::close(fd);
+		return false;
+	}
+	void* mapped = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (mapped == MAP_FAILED) {
+		return false;
+	}
+	data = static_cast<const std::uint8_t*>(mapped);
+	length = st.st_size;
+	if (std::memcmp(header().magic, "BBPZ", 4) != 0 || header().version != puzzleFileVersion || header().recordSize == 0) {
+		close();
+		return false;
+	}
+	records = (length - sizeof(PuzzleFileHeader)) / header().recordSize;
+	return true;
+}
+
+void PuzzleBank::close() {
+	if (data) {
+		munmap(const_cast<std::uint8_t*>(data), length);
+	}
+	data = 0;
+	length = 0;
+	records = 0;
+}
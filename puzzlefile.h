@@ -0,0 +1,126 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BLACKBOX_PUZZLEFILE_H
+#define BLACKBOX_PUZZLEFILE_H
+
+#include "rayengine.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+// a puzzle bank is a header followed by fixed size records, so it can be mapped and indexed directly
+// a record holds the atom bitboard words (host byte order) followed by one outcome code per entry,
+// padded to a multiple of 8 bytes
+struct PuzzleFileHeader {
+	char magic[4];			// "BBPZ"
+	std::uint16_t version;
+	std::uint8_t size;
+	std::uint8_t atoms;
+	std::uint32_t recordSize;
+	std::uint32_t words;	// number of 64 bit atom words per record
+};
+
+const std::uint16_t puzzleFileVersion = 1;
+
+// outcome codes of the signature: 0 is a hit, 1 a reflection and 2+exit an exit
+inline std::uint8_t encodeResult(const RayResult& result) {
+	return result.outcome == RAY_EXIT ? 2 + result.exit : (result.outcome == RAY_HIT ? 0 : 1);
+}
+
+inline RayResult decodeResult(std::uint8_t code) {
+	if (code == 0) {
+		return RayResult(RAY_HIT);
+	}
+	if (code == 1) {
+		return RayResult(RAY_REFLECTION);
+	}
+	return RayResult(RAY_EXIT, code - 2);
+}
+
+PuzzleFileHeader puzzleFileHeader(int size, int atoms, int words);
+
+// writes the header and hands out the record layout
+class PuzzleWriter {
+public:
+	PuzzleWriter(): file(0) {}
+	~PuzzleWriter() {
+		close();
+	}
+	bool open(const std::string& path, int size, int atoms, int words);
+	// append complete records (count*recordSize() bytes)
+	bool write(const std::uint8_t* records, std::size_t count);
+	bool close();
+
+	std::size_t recordSize() const {
+		return header.recordSize;
+	}
+
+private:
+	std::FILE* file;
+	PuzzleFileHeader header;
+};
+
+// read only view of a mapped puzzle bank
+class PuzzleBank {
+public:
+	PuzzleBank(): data(0), length(0), records(0) {}
+	~PuzzleBank() {
+		close();
+	}
+	bool open(const std::string& path);
+	void close();
+
+	const PuzzleFileHeader& header() const {
+		return *reinterpret_cast<const PuzzleFileHeader*>(data);
+	}
+
+	std::size_t count() const {
+		return records;
+	}
+
+	const std::uint64_t* atoms(std::size_t i) const {
+		return reinterpret_cast<const std::uint64_t*>(record(i));
+	}
+
+	const std::uint8_t* signature(std::size_t i) const {
+		return record(i) + 8*header().words;
+	}
+
+	// copy the atoms of a record into a board (the board needs at least as many words)
+	template <class Board>
+	void board(std::size_t i, Board& board) const {
+		board.clear();
+		const std::uint64_t* words = atoms(i);
+		for (std::uint32_t w = 0; w < header().words; ++w) {
+			for (std::uint64_t bits = words[w]; bits; bits &= bits - 1) {
+				board.setAtom(64*w + __builtin_ctzll(bits));
+			}
+		}
+	}
+
+private:
+	const std::uint8_t* record(std::size_t i) const {
+		return data + sizeof(PuzzleFileHeader) + i*header().recordSize;
+	}
+
+	const std::uint8_t* data;
+	std::size_t length;
+	std::size_t records;
+};
+
+#endif
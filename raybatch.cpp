@@ -0,0 +1,120 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "raybatch.h"
+#include "raykernel.h"
+
+namespace {
+
+bool hasAvx2() {
+#ifdef BLACKBOX_HAVE_AVX2
+	return __builtin_cpu_supports("avx2");
+#else
+	return false;
+#endif
+}
+
+}
+
+template <int Words>
+BasicRayBatch<Words>::BasicRayBatch(int size, bool vector): vector(vector && Words == 1 && hasAvx2()), engine(size) {
+	static_assert(sizeof(Bits) == 8*Words, "the kernel reads boards as an array of words");
+	// where a ray from each entry starts and where it heads, as in BasicRayEngine
+	for (int entry = 0; this->vector && entry < 4*size; ++entry) {
+		const int side = entry / size;
+		const int index = entry % size;
+		starts.push_back(side == SIDE_RIGHT ? size-1 : side == SIDE_LEFT ? 0 : index);
+		starts.push_back(side == SIDE_TOP ? size-1 : side == SIDE_BOTTOM ? 0 : index);
+		starts.push_back(side == SIDE_LEFT || side == SIDE_RIGHT ? -1 : 0);
+		starts.push_back(side == SIDE_LEFT || side == SIDE_BOTTOM ? 1 : -1);
+	}
+}
+
+template <int Words>
+void BasicRayBatch<Words>::traceAll(const Bits* boards, int count, RayResult* results) {
+	if (count <= 0) {
+		return;
+	}
+	const int entryCount = engine.entryCount();
+	if (!vector) {
+		for (int i = 0; i < count; ++i) {
+			engine.update(boards[i]);
+			for (int entry = 0; entry < entryCount; ++entry) {
+				results[i*entryCount + entry] = engine.trace(entry);
+			}
+		}
+		return;
+	}
+	boardIndex.resize(count*entryCount);
+	entries.resize(count*entryCount);
+	for (int i = 0; i < count*entryCount; ++i) {
+		boardIndex[i] = i / entryCount;
+		entries[i] = i % entryCount;
+	}
+	runKernel(boards, results);
+}
+
+template <int Words>
+void BasicRayBatch<Words>::traceBoards(const Bits* boards, int count, int entry, RayResult* results) {
+	if (count <= 0) {
+		return;
+	}
+	if (!vector) {
+		for (int i = 0; i < count; ++i) {
+			engine.update(boards[i]);
+			results[i] = engine.trace(entry);
+		}
+		return;
+	}
+	boardIndex.resize(count);
+	for (int i = 0; i < count; ++i) {
+		boardIndex[i] = i;
+	}
+	entries.assign(count, entry);
+	runKernel(boards, results);
+}
+
+template <int Words>
+void BasicRayBatch<Words>::runKernel(const Bits* boards, RayResult* results) {
+	const int count = entries.size();
+	codes.resize(count);
+#ifdef BLACKBOX_HAVE_AVX2
+	RayKernelJob job;
+	job.size = engine.size();
+	job.atoms = boards[0].words.data();
+	job.starts = starts.data();
+	job.boards = boardIndex.data();
+	job.entries = entries.data();
+	job.count = count;
+	job.codes = codes.data();
+	traceRaysAvx2(job);
+#endif
+	for (int i = 0; i < count; ++i) {
+		if (codes[i] == rayCodeHit) {
+			results[i] = RayResult(RAY_HIT);
+		} else if (codes[i] == rayCodeReflection) {
+			results[i] = RayResult(RAY_REFLECTION);
+		} else {
+			results[i] = RayResult(RAY_EXIT, codes[i]);
+		}
+	}
+}
+
+template class BasicRayBatch<1>;
+template class BasicRayBatch<4>;
+template class BasicRayBatch<16>;
+template class BasicRayBatch<64>;
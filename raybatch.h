@@ -0,0 +1,72 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BLACKBOX_RAYBATCH_H
+#define BLACKBOX_RAYBATCH_H
+
+#include "rayengine.h"
+#include <vector>
+
+// traces many rays at once for the bulk workloads (generator, hints, benchmarks)
+// on boards up to 8x8 and with avx2, sixteen rays run in lockstep, one per register lane, and
+// a lane takes the next ray as soon as its ray is done; otherwise every ray goes through
+// BasicRayEngine (on wider boards its skipping of free cells beats the lockstep kernel)
+// the outcomes are the same either way, blackbox-bench --check compares them
+template <int Words>
+class BasicRayBatch {
+public:
+	typedef BasicBlackboxBoard<Words> Board;
+	typedef typename Board::Bits Bits;
+
+	// vector = false always takes the scalar engine
+	explicit BasicRayBatch(int size, bool vector = true);
+
+	// whether the lockstep kernel is used (asked for and supported by the cpu)
+	bool vectorized() const {
+		return vector;
+	}
+
+	int size() const {
+		return engine.size();
+	}
+
+	int entryCount() const {
+		return engine.entryCount();
+	}
+
+	// every entry of many boards, results[i*entryCount() + entry] for boards[i]
+	void traceAll(const Bits* boards, int count, RayResult* results);
+
+	// one entry into many boards, results[i] for boards[i]
+	void traceBoards(const Bits* boards, int count, int entry, RayResult* results);
+
+private:
+	void runKernel(const Bits* boards, RayResult* results);
+
+	bool vector;
+	BasicRayEngine<Words> engine;
+	// kernel input, kept to avoid allocations for batches of the same size
+	std::vector<int> starts;
+	std::vector<int> boardIndex;
+	std::vector<int> entries;
+	std::vector<int> codes;
+};
+
+typedef BasicRayBatch<1> RayBatch;
+typedef BasicRayBatch<4> WideRayBatch;
+
+#endif
@@ -0,0 +1,225 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "raykernel.h"
+#include <immintrin.h>
+
+namespace {
+
+const int lanes = 8;
+
+// the start state of new rays, one column per lane
+struct Lanes {
+	alignas(32) int ray[lanes];
+	alignas(32) int entry[lanes];
+	alignas(32) int x[lanes];
+	alignas(32) int y[lanes];
+	alignas(32) int horizontal[lanes];
+	alignas(32) int incrementor[lanes];
+	alignas(32) int cell[lanes];
+	alignas(32) int atomsLow[lanes];	// the board, split into two halves
+	alignas(32) int atomsHigh[lanes];
+	alignas(32) int code[lanes];
+};
+
+inline __m256i blend(__m256i a, __m256i b, __m256i mask) {
+	return _mm256_blendv_epi8(a, b, mask);
+}
+
+inline __m256i load(const int* p) {
+	return _mm256_load_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+// eight rays in the lanes of the registers, each lane takes the next ray of the job when its ray is done
+// the lanes keep the whole board of their ray in two registers
+class Group {
+public:
+	Group(const RayKernelJob& job, int& next): job(job), next(next),
+		zero(_mm256_setzero_si256()), one(_mm256_set1_epi32(1)), minusOne(_mm256_set1_epi32(-1)),
+		n(_mm256_set1_epi32(job.size)), last(_mm256_set1_epi32(job.size-1)),
+		// a ray visits every cell in every direction at most once, more steps mean a loop
+		maxSteps(_mm256_set1_epi32(4*job.size*job.size+4)),
+		x(zero), y(zero), cell(zero), horizontal(zero), incrementor(zero), steps(zero),
+		atomsLow(zero), atomsHigh(zero), entry(zero), ray(minusOne),
+		active(zero), hit(zero), reflected(zero), fresh(zero), waiting(minusOne), fill() {
+		for (int lane = 0; lane < lanes; ++lane) {
+			fill.ray[lane] = -1;
+		}
+	}
+
+	// one step of all lanes, returns false once all rays are done
+	bool step() {
+		// lanes out of steps, beyond the border, on an atom or reflected at the entry are done
+		const __m256i expired = _mm256_cmpeq_epi32(steps, zero);
+		const __m256i finished = _mm256_and_si256(active,
+			_mm256_or_si256(_mm256_or_si256(outside(x, y), expired), _mm256_or_si256(hit, reflected)));
+		active = _mm256_andnot_si256(finished, active);
+		waiting = _mm256_or_si256(waiting, finished);
+
+		// hand out new rays once half of the lanes are done (or all that are still busy),
+		// finished lanes keep their state until then
+		const int done = _mm256_movemask_ps(_mm256_castsi256_ps(waiting));
+		if (__builtin_popcount(done) >= lanes/2 || (done && _mm256_testz_si256(active, active))) {
+			refill(done, expired);
+		}
+		if (_mm256_testz_si256(active, active)) {
+			return false;
+		}
+
+		// the neighbours of the cell, all active lanes are on the board here
+		const __m256i above = atomIn(_mm256_add_epi32(cell, one), _mm256_and_si256(active, _mm256_cmpgt_epi32(last, y)));
+		const __m256i below = atomIn(_mm256_sub_epi32(cell, one), _mm256_and_si256(active, _mm256_cmpgt_epi32(y, zero)));
+		__m256i right = atomIn(_mm256_add_epi32(cell, n), _mm256_and_si256(active, _mm256_cmpgt_epi32(last, x)));
+		__m256i left = atomIn(_mm256_sub_epi32(cell, n), _mm256_and_si256(active, _mm256_cmpgt_epi32(x, zero)));
+
+		// if atom left or right of straight path at the entry: reflect, before anything else
+		// (both stay set on waiting lanes until they get a new ray)
+		const __m256i entered = _mm256_and_si256(fresh, blend(_mm256_or_si256(right, left), _mm256_or_si256(above, below), horizontal));
+		const __m256i struck = _mm256_andnot_si256(entered, atomIn(cell, active));
+		reflected = _mm256_or_si256(reflected, entered);
+		hit = _mm256_or_si256(hit, struck);
+		fresh = zero;
+		const __m256i live = _mm256_andnot_si256(_mm256_or_si256(entered, struck), active);
+
+		// a horizontal ray that turns aside goes back one cell along x, of the neighbours there one
+		// is the current cell (no atom) and the other one is two cells back
+		const __m256i alongX = _mm256_and_si256(live, horizontal);
+		const __m256i backX = _mm256_sub_epi32(x, _mm256_add_epi32(incrementor, incrementor));
+		const __m256i backCell = _mm256_sub_epi32(cell, _mm256_sign_epi32(_mm256_add_epi32(n, n), incrementor));
+		const __m256i back = atomIn(backCell, _mm256_andnot_si256(
+			_mm256_or_si256(_mm256_cmpgt_epi32(zero, backX), _mm256_cmpgt_epi32(backX, last)), alongX));
+		const __m256i forwardX = _mm256_cmpgt_epi32(incrementor, zero);
+
+		// the four deflection checks one after the other on the updated state, as in BasicRayEngine
+		__m256i stay = zero;
+		__m256i moved = zero;
+		deflect(_mm256_and_si256(alongX, above), below, x, n, minusOne, stay, moved);
+		deflect(_mm256_and_si256(_mm256_andnot_si256(_mm256_or_si256(stay, moved), alongX), below), above, x, n, one, stay, moved);
+		right = blend(right, _mm256_andnot_si256(forwardX, back), moved);
+		left = blend(left, _mm256_and_si256(forwardX, back), moved);
+		const __m256i alongY = _mm256_andnot_si256(_mm256_or_si256(horizontal, stay), live);
+		deflect(_mm256_and_si256(alongY, right), left, y, one, minusOne, stay, moved);
+		deflect(_mm256_and_si256(_mm256_andnot_si256(_mm256_or_si256(horizontal, stay), alongY), left), right, y, one, one, stay, moved);
+
+		// next step of ray
+		const __m256i move = _mm256_and_si256(_mm256_andnot_si256(stay, live), incrementor);
+		x = _mm256_add_epi32(x, _mm256_and_si256(horizontal, move));
+		y = _mm256_add_epi32(y, _mm256_andnot_si256(horizontal, move));
+		cell = _mm256_add_epi32(cell, blend(move, _mm256_sign_epi32(n, move), horizontal));
+		steps = _mm256_add_epi32(steps, live);
+		return true;
+	}
+
+private:
+	__m256i outside(__m256i px, __m256i py) const {
+		return _mm256_or_si256(_mm256_or_si256(_mm256_cmpgt_epi32(zero, px), _mm256_cmpgt_epi32(px, last)),
+			_mm256_or_si256(_mm256_cmpgt_epi32(zero, py), _mm256_cmpgt_epi32(py, last)));
+	}
+
+	// all ones on the lanes of mask with an atom at the cell, the cell must be on the board for these lanes
+	__m256i atomIn(__m256i at, __m256i mask) const {
+		// shifts by 32 or more (and negative ones) give zero
+		const __m256i bits = _mm256_or_si256(_mm256_srlv_epi32(atomsLow, at), _mm256_srlv_epi32(atomsHigh, _mm256_sub_epi32(at, _mm256_set1_epi32(32))));
+		return _mm256_and_si256(mask, _mm256_cmpeq_epi32(_mm256_and_si256(bits, one), one));
+	}
+
+	// a double deflection turns around and skips the step, a single one turns aside
+	void deflect(__m256i found, __m256i other, __m256i& position, __m256i stride, __m256i turn, __m256i& stay, __m256i& moved) {
+		const __m256i twice = _mm256_and_si256(found, other);
+		const __m256i once = _mm256_andnot_si256(twice, found);
+		position = _mm256_sub_epi32(position, _mm256_and_si256(found, incrementor));
+		cell = _mm256_sub_epi32(cell, _mm256_and_si256(found, _mm256_sign_epi32(stride, incrementor)));
+		incrementor = blend(incrementor, _mm256_sub_epi32(zero, incrementor), twice);
+		incrementor = blend(incrementor, turn, once);
+		horizontal = _mm256_xor_si256(horizontal, once);
+		stay = _mm256_or_si256(stay, twice);
+		moved = _mm256_or_si256(moved, once);
+	}
+
+	// write the outcomes of the waiting lanes and start the next rays on them
+	void refill(int done, __m256i expired) {
+		// the raycube at the border, or the entry itself
+		const __m256i exit = blend(blend(blend(_mm256_add_epi32(_mm256_add_epi32(n, _mm256_add_epi32(n, n)), x),
+			_mm256_add_epi32(_mm256_add_epi32(n, n), x), _mm256_cmpgt_epi32(zero, y)),
+			_mm256_add_epi32(n, y), _mm256_cmpgt_epi32(x, last)),
+			y, _mm256_cmpgt_epi32(zero, x));
+		__m256i code = blend(exit, _mm256_set1_epi32(rayCodeReflection),
+			_mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi32(exit, entry), expired), reflected));
+		code = blend(code, _mm256_set1_epi32(rayCodeHit), hit);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(fill.code), code);
+
+		// the next rays in lane order, with their start state from the table of entries
+		for (int pending = done; pending; pending &= pending-1) {
+			const int lane = __builtin_ctz(pending);
+			if (fill.ray[lane] >= 0) {
+				job.codes[fill.ray[lane]] = fill.code[lane];
+			}
+			const int r = next < job.count ? next++ : -1;
+			fill.ray[lane] = r;
+			if (r >= 0) {
+				const int* start = job.starts + 4*job.entries[r];
+				const std::uint64_t atoms = job.atoms[job.boards[r]];
+				fill.entry[lane] = job.entries[r];
+				fill.x[lane] = start[0];
+				fill.y[lane] = start[1];
+				fill.horizontal[lane] = start[2];
+				fill.incrementor[lane] = start[3];
+				fill.cell[lane] = start[0]*job.size + start[1];
+				fill.atomsLow[lane] = int(atoms);
+				fill.atomsHigh[lane] = int(atoms >> 32);
+			}
+		}
+		ray = blend(ray, load(fill.ray), waiting);
+		fresh = _mm256_and_si256(waiting, _mm256_cmpgt_epi32(ray, minusOne));
+		active = _mm256_or_si256(active, fresh);
+		waiting = zero;
+		entry = blend(entry, load(fill.entry), fresh);
+		x = blend(x, load(fill.x), fresh);
+		y = blend(y, load(fill.y), fresh);
+		horizontal = blend(horizontal, load(fill.horizontal), fresh);
+		incrementor = blend(incrementor, load(fill.incrementor), fresh);
+		cell = blend(cell, load(fill.cell), fresh);
+		steps = blend(steps, maxSteps, fresh);
+		hit = _mm256_andnot_si256(fresh, hit);
+		reflected = _mm256_andnot_si256(fresh, reflected);
+		atomsLow = blend(atomsLow, load(fill.atomsLow), fresh);
+		atomsHigh = blend(atomsHigh, load(fill.atomsHigh), fresh);
+	}
+
+	const RayKernelJob& job;
+	int& next;
+	const __m256i zero, one, minusOne, n, last, maxSteps;
+	__m256i x, y, cell, horizontal, incrementor, steps;
+	__m256i atomsLow, atomsHigh, entry, ray;
+	__m256i active, hit, reflected;
+	// lanes with a new ray, they check for the reflection at the entry first
+	__m256i fresh;
+	// finished lanes waiting for a new ray (all lanes at the start)
+	__m256i waiting;
+	Lanes fill;
+};
+
+}
+
+// two groups of eight lanes, the steps of one group overlap the dependency chains of the other
+void traceRaysAvx2(const RayKernelJob& job) {
+	int next = 0;
+	Group first(job, next);
+	Group second(job, next);
+	while (first.step() | second.step()) {
+	}
+}
@@ -0,0 +1,228 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "rayengine.h"
+
+template <int Words>
+BasicRayEngine<Words>::BasicRayEngine(const Board& board) {
+	update(board);
+}
+
+template <int Words>
+BasicRayEngine<Words>::BasicRayEngine(int size): boardSize(size) {
+}
+
+template <int Words>
+void BasicRayEngine<Words>::update(const Board& board) {
+	boardSize = board.size();
+	update(board.atoms());
+}
+
+template <int Words>
+void BasicRayEngine<Words>::update(const Bits& atomBits) {
+	atoms.clear();
+	nearAtom.clear();
+	atomBits.forEach([&](int cell) { addAtom(cell); });
+}
+
+template <int Words>
+void BasicRayEngine<Words>::addAtom(int cell) {
+	int x = cell / boardSize;
+	int y = cell % boardSize;
+	atoms.set(cell);
+	nearAtom.set(cell);
+	if (x > 0) nearAtom.set(cell-boardSize);
+	if (x < boardSize-1) nearAtom.set(cell+boardSize);
+	if (y > 0) nearAtom.set(cell-1);
+	if (y < boardSize-1) nearAtom.set(cell+1);
+}
+
+template <int Words>
+RayResult BasicRayEngine<Words>::trace(int entry) const {
+	RayResult result;
+	NoPath path;
+	run<false>(entry, 0, result, path);
+	return result;
+}
+
+template <int Words>
+bool BasicRayEngine<Words>::tracePartial(int entry, int decided, RayResult& result) const {
+	NoPath path;
+	if (decided >= boardSize*boardSize) {
+		return run<false>(entry, 0, result, path);
+	}
+	return run<true>(entry, decided, result, path);
+}
+
+template <int Words>
+RayResult BasicRayEngine<Words>::tracePath(int entry, std::vector<RayPoint>& corners) const {
+	corners.clear();
+	RayResult result;
+	CornerPath path = {corners};
+	run<false>(entry, 0, result, path);
+	return result;
+}
+
+template <int Words>
+template <bool Partial, class Path>
+bool BasicRayEngine<Words>::run(int entry, int decided, RayResult& result, Path& path) const {
+	const int n = boardSize;
+	const int side = entry / n;
+	const int index = entry % n;
+
+	// init variables dependent on the raycube clicked
+	bool horizontal = side == SIDE_LEFT || side == SIDE_RIGHT;
+	int incrementor = (side == SIDE_LEFT || side == SIDE_BOTTOM) ? 1 : -1;
+	int x = 0;
+	int y = 0;
+	if (side == SIDE_LEFT) {
+		y = index;
+	} else if (side == SIDE_RIGHT) {
+		x = n-1;
+		y = index;
+	} else if (side == SIDE_BOTTOM) {
+		x = index;
+	} else {
+		y = n-1;
+		x = index;
+	}
+	// the raycube in front of the first cell
+	path.add(horizontal ? x - incrementor : x, horizontal ? y : y - incrementor);
+
+	// set as soon as an unknown cell is looked at (only for partial boards)
+	bool unknown = false;
+	auto atomAt = [&](int ax, int ay) { return this->template probe<Partial>(ax, ay, decided, unknown); };
+
+	// if atom left or right of straight path: if step==0: reflect
+	if ((horizontal && (atomAt(x, y+1) || atomAt(x, y-1)))
+	|| (!horizontal && (atomAt(x+1, y) || atomAt(x-1, y)))) {
+		result = RayResult(RAY_REFLECTION);
+		return !unknown;
+	}
+
+	// a ray visits every cell in every direction at most once, more steps mean a loop
+	for (int steps = 4*n*n+4; steps > 0; --steps) {
+		if (Partial && unknown) {
+			return false;
+		}
+
+		// if border reached: leave through the raycube there
+		if (x >= n || x < 0 || y >= n || y < 0) {
+			int exit;
+			if (x < 0) {
+				exit = SIDE_LEFT*n + y;
+			} else if (x >= n) {
+				exit = SIDE_RIGHT*n + y;
+			} else if (y < 0) {
+				exit = SIDE_BOTTOM*n + x;
+			} else {
+				exit = SIDE_TOP*n + x;
+			}
+			path.add(x, y);
+			if (exit == entry) {
+				result = RayResult(RAY_REFLECTION);
+			} else {
+				result = RayResult(RAY_EXIT, exit);
+			}
+			return true;
+		}
+
+		// nothing to check away from atoms (as long as all neighbours are known)
+		if (!nearAtom.test(x*n+y) && (!Partial || lastNeighbour(x, y) < decided)) {
+			if (horizontal) {
+				x += incrementor;
+			} else {
+				y += incrementor;
+			}
+			continue;
+		}
+
+		// if atom in straight path: hit
+		if (atomAt(x, y)) {
+			path.add(x, y);
+			result = RayResult(RAY_HIT);
+			return true;
+		}
+
+		// if atom left or right of straight path: change path away from atom (deflect)
+		// the checks run one after the other on the updated state, just like the original game loop
+		if (horizontal && atomAt(x, y+1)) {
+			if (atomAt(x, y-1)) {
+				// double deflection on horizontal path
+				x -= incrementor;
+				incrementor *= -1;
+				path.add(x, y);
+				continue;
+			}
+			horizontal = !horizontal;
+			x -= incrementor;
+			incrementor = -1;
+			path.add(x, y);
+		}
+		if (horizontal && atomAt(x, y-1)) {
+			if (atomAt(x, y+1)) {
+				x -= incrementor;
+				incrementor *= -1;
+				path.add(x, y);
+				continue;
+			}
+			horizontal = !horizontal;
+			x -= incrementor;
+			incrementor = 1;
+			path.add(x, y);
+		}
+		if (!horizontal && atomAt(x+1, y)) {
+			if (atomAt(x-1, y)) {
+				// double deflection on vertical path
+				y -= incrementor;
+				incrementor *= -1;
+				path.add(x, y);
+				continue;
+			}
+			horizontal = !horizontal;
+			y -= incrementor;
+			incrementor = -1;
+			path.add(x, y);
+		}
+		if (!horizontal && atomAt(x-1, y)) {
+			if (atomAt(x+1, y)) {
+				y -= incrementor;
+				incrementor *= -1;
+				path.add(x, y);
+				continue;
+			}
+			horizontal = !horizontal;
+			y -= incrementor;
+			incrementor = 1;
+			path.add(x, y);
+		}
+
+		// next step of ray
+		if (horizontal) {
+			x += incrementor;
+		} else {
+			y += incrementor;
+		}
+	}
+	result = RayResult(RAY_REFLECTION);
+	return !unknown;
+}
+
+template class BasicRayEngine<1>;
+template class BasicRayEngine<4>;
+template class BasicRayEngine<16>;
+template class BasicRayEngine<64>;
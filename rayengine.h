@@ -0,0 +1,148 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BLACKBOX_RAYENGINE_H
+#define BLACKBOX_RAYENGINE_H
+
+#include "board.h"
+#include <vector>
+
+// the sides of the gameboard rays can enter from, in the order of the raycubes vectors
+// a ray entry (or exit) is identified by side*size+index
+enum RaySide {
+	SIDE_LEFT = 0,	// enters at x = 0 moving along x
+	SIDE_RIGHT,		// enters at x = size-1 moving against x
+	SIDE_BOTTOM,	// enters at y = 0 moving along y
+	SIDE_TOP		// enters at y = size-1 moving against y
+};
+
+enum RayOutcome {
+	RAY_HIT = 0,
+	RAY_REFLECTION,
+	RAY_EXIT
+};
+
+struct RayResult {
+	RayOutcome outcome;
+	int exit;	// entry id of the raycube the ray leaves through (only for RAY_EXIT)
+	RayResult(RayOutcome outcome = RAY_HIT, int exit = -1): outcome(outcome), exit(exit) {}
+	bool operator==(const RayResult& other) const {
+		return outcome == other.outcome && exit == other.exit;
+	}
+	bool operator!=(const RayResult& other) const {
+		return !(*this == other);
+	}
+};
+
+// a corner of a ray path in the coordinates of the ray logic
+// the first and last corner of a ray that leaves the board lie just outside of it, on the raycubes
+struct RayPoint {
+	int x;
+	int y;
+	RayPoint(int x = 0, int y = 0): x(x), y(y) {}
+};
+
+// traces rays through a board without any scene nodes
+// the cells holding or touching an atom are precomputed into a mask, so a ray only
+// needs a single bit test per free step and the full neighbour checks next to atoms
+template <int Words>
+class BasicRayEngine {
+public:
+	typedef BasicBlackboxBoard<Words> Board;
+	typedef typename Board::Bits Bits;
+
+	explicit BasicRayEngine(const Board& board);
+	// an engine for an empty board of the given size
+	explicit BasicRayEngine(int size);
+
+	// recompute the masks after the atoms changed
+	void update(const Board& board);
+	// the same for a bare set of atoms on a board of the current size
+	void update(const Bits& atomBits);
+
+	// place one more atom without recomputing the masks
+	void addAtom(int cell);
+
+	int size() const {
+		return boardSize;
+	}
+
+	int entryCount() const {
+		return 4*boardSize;
+	}
+
+	// shoot a ray from the given entry (side*size+index)
+	RayResult trace(int entry) const;
+
+	// shoot a ray while only the cells below decided are known (atoms beyond are unknown)
+	// returns false if the outcome depends on an unknown cell
+	bool tracePartial(int entry, int decided, RayResult& result) const;
+
+	// shoot a ray and keep the corners of its path: the raycube it enters from, every cell it turns on
+	// and the raycube it leaves through or the atom it hits
+	RayResult tracePath(int entry, std::vector<RayPoint>& path) const;
+
+private:
+	// the path of the plain traces, which nobody looks at
+	struct NoPath {
+		void add(int, int) {}
+	};
+
+	struct CornerPath {
+		std::vector<RayPoint>& corners;
+		void add(int x, int y) {
+			corners.push_back(RayPoint(x, y));
+		}
+	};
+
+	template <bool Partial, class Path>
+	bool run(int entry, int decided, RayResult& result, Path& path) const;
+
+	// whether there is an atom at x, y (outside of the board there never is)
+	template <bool Partial>
+	bool probe(int x, int y, int decided, bool& unknown) const {
+		if (x < 0 || x >= boardSize || y < 0 || y >= boardSize) {
+			return false;
+		}
+		if (Partial && x*boardSize+y >= decided) {
+			unknown = true;
+			return false;
+		}
+		return atoms.test(x*boardSize+y);
+	}
+
+	// highest cell id among a cell and its neighbours
+	int lastNeighbour(int x, int y) const {
+		if (x < boardSize-1) {
+			return (x+1)*boardSize+y;
+		}
+		if (y < boardSize-1) {
+			return x*boardSize+y+1;
+		}
+		return x*boardSize+y;
+	}
+
+	int boardSize;
+	Bits atoms;
+	// atoms and their direct neighbours, a ray may only change course on these cells
+	Bits nearAtom;
+};
+
+typedef BasicRayEngine<1> RayEngine;
+typedef BasicRayEngine<4> WideRayEngine;
+
+#endif
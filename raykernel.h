@@ -0,0 +1,44 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BLACKBOX_RAYKERNEL_H
+#define BLACKBOX_RAYKERNEL_H
+
+#include <cstdint>
+
+// the lockstep ray kernel behind BasicRayBatch
+// it only sees plain arrays: the avx2 unit must not share inline code (templates, the
+// standard library) with the rest of the program, the linker might pick its avx2 copy
+
+// ray i enters board boards[i] at entries[i] and its outcome goes to codes[i]
+struct RayKernelJob {
+	int size;						// at most 8, a board is a single word
+	const std::uint64_t* atoms;		// atoms of board b at atoms[b]
+	const int* starts;				// x, y, horizontal (-1 or 0) and incrementor of every entry
+	const int* boards;
+	const int* entries;
+	int count;
+	int* codes;						// the exit entry, rayCodeHit or rayCodeReflection
+};
+
+const int rayCodeHit = -1;
+const int rayCodeReflection = -2;
+
+// 16 rays at a time in the lanes of avx2 registers, only call this if the cpu has avx2
+void traceRaysAvx2(const RayKernelJob& job);
+
+#endif
@@ -0,0 +1,149 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "raypathnode.h"
+
+using namespace irr;
+
+RayPathNode::RayPathNode(scene::ISceneNode* parent, scene::ISceneManager* mgr, const BoardSceneNode* board, float speed):
+	scene::ISceneNode(parent, mgr), board(board), cellsPerSecond(speed), firstVertex(0), firstIndex(0), growStart(0),
+	growing(false), started(false), changed(false) {
+	const int size = board->size();
+	cellLength = size > 1 ? board->getCubePosition(1).getDistanceFrom(board->getCubePosition(0)) : 1;
+	// just above the cubes (the camera looks along y)
+	box = board->getBoundingBox();
+	height = box.MinEdge.Y - 0.5f;
+	// a few corners per ray, so the lists do not grow in the frame loop
+	vertices.reserve(4*size*16);
+	indices.reserve(4*size*32);
+	corners.reserve(4*size);
+
+	material.setFlag(video::EMF_LIGHTING, false);
+	material.Thickness = 3;
+}
+
+core::vector3df RayPathNode::position(const RayPoint& point) const {
+	const int size = board->size();
+	core::vector3df result;
+	if (point.x < 0) {
+		result = board->getRaycubePosition(SIDE_LEFT*size + point.y);
+	} else if (point.x >= size) {
+		result = board->getRaycubePosition(SIDE_RIGHT*size + point.y);
+	} else if (point.y < 0) {
+		result = board->getRaycubePosition(SIDE_BOTTOM*size + point.x);
+	} else if (point.y >= size) {
+		result = board->getRaycubePosition(SIDE_TOP*size + point.x);
+	} else {
+		result = board->getCubePosition(point.x*size + point.y);
+	}
+	result.Y = height;
+	return result;
+}
+
+void RayPathNode::addPath(const std::vector<RayPoint>& path, video::SColor color, bool animate) {
+	if (growing) {
+		finishGrowing();
+	}
+	corners.clear();
+	for (const RayPoint& point : path) {
+		corners.push_back(position(point));
+	}
+	growingColor = color;
+	firstVertex = vertices.size();
+	firstIndex = indices.size();
+	// the path starts growing with the next frame, however long ago the last one was drawn
+	growing = corners.size() > 1;
+	started = false;
+	changed = true;
+	if (growing && !animate) {
+		finishGrowing();
+	}
+}
+
+void RayPathNode::clear() {
+	vertices.clear();
+	indices.clear();
+	corners.clear();
+	growing = false;
+	changed = true;
+}
+
+bool RayPathNode::grow(float length) {
+	vertices.resize(firstVertex);
+	indices.resize(firstIndex);
+	video::S3DVertex vertex(corners[0], core::vector3df(0,-1,0), growingColor, core::vector2df(0,0));
+	vertices.push_back(vertex);
+	for (std::size_t i = 1; i < corners.size(); ++i) {
+		float segment = corners[i].getDistanceFrom(corners[i-1]);
+		bool complete = segment <= length;
+		// the tip of a growing path lies within its last segment
+		vertex.Pos = complete ? corners[i] : corners[i-1] + (corners[i] - corners[i-1]) * (length / segment);
+		indices.push_back(vertices.size()-1);
+		indices.push_back(vertices.size());
+		vertices.push_back(vertex);
+		if (!complete) {
+			return true;
+		}
+		length -= segment;
+	}
+	return false;
+}
+
+void RayPathNode::finishGrowing() {
+	grow(1e30f);
+	growing = false;
+	changed = true;
+}
+
+void RayPathNode::OnAnimate(u32 timeMs) {
+	if (growing) {
+		if (!started) {
+			growStart = timeMs;
+			started = true;
+		}
+		growing = grow(cellsPerSecond * cellLength * (timeMs - growStart) / 1000.0f);
+		changed = true;
+	}
+	ISceneNode::OnAnimate(timeMs);
+}
+
+void RayPathNode::OnRegisterSceneNode() {
+	if (IsVisible && !indices.empty()) {
+		SceneManager->registerNodeForRendering(this);
+	}
+	ISceneNode::OnRegisterSceneNode();
+}
+
+void RayPathNode::render() {
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+	driver->setTransform(video::ETS_WORLD, AbsoluteTransformation);
+	driver->setMaterial(material);
+	driver->drawVertexPrimitiveList(vertices.data(), vertices.size(), indices.data(), indices.size()/2,
+		video::EVT_STANDARD, scene::EPT_LINES, video::EIT_32BIT);
+}
+
+const core::aabbox3d<f32>& RayPathNode::getBoundingBox() const {
+	return box;
+}
+
+u32 RayPathNode::getMaterialCount() const {
+	return 1;
+}
+
+video::SMaterial& RayPathNode::getMaterial(u32 /*i*/) {
+	return material;
+}
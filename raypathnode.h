@@ -0,0 +1,84 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BLACKBOX_RAYPATHNODE_H
+#define BLACKBOX_RAYPATHNODE_H
+
+#include "boardnode.h"
+#include "rayengine.h"
+#include <irrlicht.h>
+#include <vector>
+
+// draws the paths of the fired rays as lines above the board
+// all paths share one vertex and index list that is drawn with a single call, so the cost stays
+// the same for hundreds of rays; the newest path grows from its raycube until it is complete
+class RayPathNode : public irr::scene::ISceneNode {
+public:
+	// speed is the length of path drawn per second, in cells
+	RayPathNode(irr::scene::ISceneNode* parent, irr::scene::ISceneManager* mgr, const BoardSceneNode* board, float speed);
+
+	// add the path of a ray (see BasicRayEngine::tracePath), a path that is still growing is completed
+	// without animate the path is complete right away
+	void addPath(const std::vector<RayPoint>& corners, irr::video::SColor color, bool animate = true);
+	// remove all paths
+	void clear();
+
+	// whether a path is still growing (the board has to be drawn again)
+	bool animating() const {
+		return growing;
+	}
+
+	// whether the paths changed since the last call
+	bool takeChanged() {
+		bool was = changed;
+		changed = false;
+		return was;
+	}
+
+	virtual void OnRegisterSceneNode();
+	virtual void OnAnimate(irr::u32 timeMs);
+	virtual void render();
+	virtual const irr::core::aabbox3d<irr::f32>& getBoundingBox() const;
+	virtual irr::u32 getMaterialCount() const;
+	virtual irr::video::SMaterial& getMaterial(irr::u32 i);
+
+private:
+	irr::core::vector3df position(const RayPoint& point) const;
+	// put the growing path into the lists up to the given length, returns false once it is complete
+	bool grow(float length);
+	void finishGrowing();
+
+	const BoardSceneNode* board;
+	float cellsPerSecond;
+	float cellLength;
+	float height;
+	std::vector<irr::video::S3DVertex> vertices;
+	std::vector<irr::u32> indices;
+	// the corners of the growing path, it is kept behind the first free vertex and index
+	std::vector<irr::core::vector3df> corners;
+	irr::video::SColor growingColor;
+	irr::u32 firstVertex;
+	irr::u32 firstIndex;
+	irr::u32 growStart;
+	bool growing;
+	bool started;
+	bool changed;
+	irr::video::SMaterial material;
+	irr::core::aabbox3df box;
+};
+
+#endif
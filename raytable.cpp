@@ -0,0 +1,44 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "raytable.h"
+
+template <int Words>
+BasicRayTable<Words>::BasicRayTable(const Board& board): engine(board.size()) {
+	// the masks are computed by reset
+	reset(board);
+}
+
+template <int Words>
+void BasicRayTable<Words>::reset(const Board& board) {
+	engine.update(board);
+	// keeps the capacity, so a reset of a board with the same size does not allocate
+	outcomes.resize(engine.entryCount());
+	known.assign(engine.entryCount(), 0);
+}
+
+template <int Words>
+void BasicRayTable<Words>::fill() {
+	for (int entry = 0; entry < entryCount(); ++entry) {
+		outcome(entry);
+	}
+}
+
+template class BasicRayTable<1>;
+template class BasicRayTable<4>;
+template class BasicRayTable<16>;
+template class BasicRayTable<64>;
@@ -0,0 +1,65 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BLACKBOX_RAYTABLE_H
+#define BLACKBOX_RAYTABLE_H
+
+#include "rayengine.h"
+#include <vector>
+
+// the outcome of every entry of a board, each ray is traced at most once per board
+// entries are traced lazily on their first query, fill() traces all of them up front
+template <int Words>
+class BasicRayTable {
+public:
+	typedef BasicBlackboxBoard<Words> Board;
+
+	explicit BasicRayTable(const Board& board);
+
+	// forget all outcomes and use the atoms of the given board
+	void reset(const Board& board);
+
+	// trace all entries that have not been traced yet
+	void fill();
+
+	int entryCount() const {
+		return engine.entryCount();
+	}
+
+	const RayResult& outcome(int entry) {
+		if (!known[entry]) {
+			outcomes[entry] = engine.trace(entry);
+			known[entry] = 1;
+		}
+		return outcomes[entry];
+	}
+
+	// the corners of the path of a ray (traced again, paths are not kept)
+	void path(int entry, std::vector<RayPoint>& corners) const {
+		engine.tracePath(entry, corners);
+	}
+
+private:
+	BasicRayEngine<Words> engine;
+	std::vector<RayResult> outcomes;
+	std::vector<char> known;
+};
+
+typedef BasicRayTable<1> RayTable;
+typedef BasicRayTable<4> WideRayTable;
+
+#endif
@@ -0,0 +1,245 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <irrlicht.h>
+#include "assets.h"
+#include "boardnode.h"
+#include "boardview.h"
+#include "game.h"
+#include "puzzlefile.h"
+#include "raypathnode.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace irr;
+
+namespace {
+
+struct Options {
+	std::string bank;
+	std::string output = ".";
+	std::size_t first = 0;
+	std::size_t count = 0;
+	int width = 512;
+	int height = 512;
+	int threads = 0;
+	bool paths = false;
+	bool atoms = false;
+};
+
+void usage() {
+	std::cerr << "usage: blackbox-render [-f first] [-n count] [-w width] [-h height] [-j threads] [-p] [-a] [-o dir] bank" << std::endl;
+	std::cerr << "  renders a png per board of a puzzle bank (see blackbox-gen) with all rays fired" << std::endl;
+	std::cerr << "  -p draws the ray paths, -a shows the hidden atoms" << std::endl;
+}
+
+#ifdef BLACKBOX_RENDER_DISPLAY
+// built for a display (see CMakeLists.txt): the window devices of several threads cannot share one
+// connection to the window system safely, so a single device draws all boards
+const E_DEVICE_TYPE renderDevice = EIDT_BEST;
+const char* const deviceName = "a window device (is DISPLAY set?)";
+const bool singleDevice = true;
+#else
+// the console device needs no display
+const E_DEVICE_TYPE renderDevice = EIDT_CONSOLE;
+const char* const deviceName = "the console device (irrlicht has to be built with _IRR_COMPILE_WITH_CONSOLE_DEVICE_)";
+const bool singleDevice = false;
+#endif
+
+// creating and dropping devices is not safe to run concurrently
+std::mutex deviceMutex;
+
+IrrlichtDevice* createRenderDevice(const Options& options) {
+	std::lock_guard<std::mutex> lock(deviceMutex);
+	SIrrlichtCreationParameters params;
+	params.DriverType = video::EDT_BURNINGSVIDEO;
+	params.WindowSize = core::dimension2du(options.width, options.height);
+	params.LoggingLevel = ELL_ERROR;
+	params.DeviceType = renderDevice;
+	return createDeviceEx(params);
+}
+
+void dropRenderDevice(IrrlichtDevice* device) {
+	std::lock_guard<std::mutex> lock(deviceMutex);
+	device->drop();
+}
+
+// one device and one board per thread, the threads take the next board until all are drawn
+bool render(const Options& options, const PuzzleBank& bank, std::atomic<std::size_t>& next, std::size_t end, std::atomic<std::size_t>& written) {
+	IrrlichtDevice* device = createRenderDevice(options);
+	if (!device) {
+		return false;
+	}
+	video::IVideoDriver* driver = device->getVideoDriver();
+	scene::ISceneManager* smgr = device->getSceneManager();
+	smgr->setAmbientLight(video::SColorf(1,1,1));
+
+	const int size = bank.header().size;
+	scene::SMesh* cube = createBakedMesh(cubeMesh);
+	scene::SMesh* atom = createBakedMesh(atomMesh);
+	BoardSceneNode* boardNode = new BoardSceneNode(smgr->getRootSceneNode(), smgr, size, -(3*size)/2, cube, atom, cubeColor, raycubeColor, atomColor);
+	boardNode->drop();
+	cube->drop();
+	atom->drop();
+	RayPathNode* pathNode = new RayPathNode(smgr->getRootSceneNode(), smgr, boardNode, 0);
+	pathNode->drop();
+	scene::ICameraSceneNode* camera = smgr->addCameraSceneNode(0, core::vector3df(0,-cameraDistance(size),0), core::vector3df(0,0,0));
+	camera->setAspectRatio(float(options.width) / options.height);
+
+	video::ITexture* target = driver->addRenderTargetTexture(core::dimension2du(options.width, options.height), "thumbnail", video::ECF_A8R8G8B8);
+	if (!target) {
+		dropRenderDevice(device);
+		return false;
+	}
+
+	Game game(size, 0, 0);
+	std::vector<int> atoms;
+	std::vector<RayPoint> corners;
+	char path[4096];
+	bool ok = true;
+	for (std::size_t i = next.fetch_add(1); i < end && ok; i = next.fetch_add(1)) {
+		atoms.clear();
+		const std::uint64_t* words = bank.atoms(i);
+		for (std::uint32_t w = 0; w < bank.header().words; ++w) {
+			for (std::uint64_t bits = words[w]; bits; bits &= bits - 1) {
+				atoms.push_back(64*w + __builtin_ctzll(bits));
+			}
+		}
+		game.reset(atoms);
+		for (int entry = 0; entry < 4*size; ++entry) {
+			game.fire(entry);
+		}
+		showGame(game, boardNode);
+		for (int cell : atoms) {
+			boardNode->setAtomVisible(cell, options.atoms);
+		}
+		pathNode->clear();
+		if (options.paths) {
+			for (auto & ray : game.rays()) {
+				game.rayPath(ray.entry, corners);
+				pathNode->addPath(corners, rayColor(game.raycube(ray.entry)), false);
+			}
+		}
+
+		// the frame only goes to the render target, so the scene is never presented (endScene is left out)
+		driver->beginScene(false, false);
+		driver->setRenderTarget(target, true, true, video::SColor(255,150,150,255));
+		smgr->drawAll();
+		driver->setRenderTarget(0, false, false);
+
+		video::IImage* image = driver->createImage(target, core::position2di(0,0), target->getSize());
+		std::snprintf(path, sizeof(path), "%s/board%08zu.png", options.output.c_str(), i);
+		ok = image && driver->writeImageToFile(image, path);
+		if (image) {
+			image->drop();
+		}
+		written += ok;
+	}
+	dropRenderDevice(device);
+	return ok;
+}
+
+}
+
+int main(int argc, char** argv) {
+	Options options;
+	for (int i = 1; i < argc; ++i) {
+		if (!std::strcmp(argv[i], "-f") && i+1 < argc) {
+			options.first = std::strtoull(argv[++i], 0, 10);
+		} else if (!std::strcmp(argv[i], "-n") && i+1 < argc) {
+			options.count = std::strtoull(argv[++i], 0, 10);
+		} else if (!std::strcmp(argv[i], "-w") && i+1 < argc) {
+			options.width = std::atoi(argv[++i]);
+		} else if (!std::strcmp(argv[i], "-h") && i+1 < argc) {
+			options.height = std::atoi(argv[++i]);
+		} else if (!std::strcmp(argv[i], "-j") && i+1 < argc) {
+			options.threads = std::atoi(argv[++i]);
+		} else if (!std::strcmp(argv[i], "-o") && i+1 < argc) {
+			options.output = argv[++i];
+		} else if (!std::strcmp(argv[i], "-p")) {
+			options.paths = true;
+		} else if (!std::strcmp(argv[i], "-a")) {
+			options.atoms = true;
+		} else if (argv[i][0] != '-' && options.bank.empty()) {
+			options.bank = argv[i];
+		} else {
+			usage();
+			return 1;
+		}
+	}
+	if (options.bank.empty() || options.width <= 0 || options.height <= 0) {
+		usage();
+		return 1;
+	}
+
+	PuzzleBank bank;
+	if (!bank.open(options.bank)) {
+		std::cerr << "could not open " << options.bank << std::endl;
+		return 1;
+	}
+	if (bank.header().size < 1 || bank.header().size > maxBoardSize) {
+		std::cerr << options.bank << " holds unsupported boards" << std::endl;
+		return 1;
+	}
+	std::size_t end = options.count ? std::min(bank.count(), options.first + options.count) : bank.count();
+
+	// no other device is tried, a window instead of the console device would not run headless
+	IrrlichtDevice* probe = createRenderDevice(options);
+	if (!probe) {
+		std::cerr << "could not create " << deviceName << std::endl;
+		return 1;
+	}
+	dropRenderDevice(probe);
+
+	auto start = std::chrono::steady_clock::now();
+	std::atomic<std::size_t> next(options.first);
+	std::atomic<std::size_t> written(0);
+	std::atomic<bool> failed(false);
+	auto work = [&]() {
+		if (!render(options, bank, next, end, written)) {
+			failed.store(true);
+		}
+	};
+	unsigned int threads = options.threads > 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+	if (singleDevice) {
+		threads = 1;
+	}
+	std::vector<std::thread> workers;
+	for (unsigned int i = 1; i < threads; ++i) {
+		workers.emplace_back(work);
+	}
+	work();
+	for (auto & worker : workers) {
+		worker.join();
+	}
+	std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+	std::cerr << written.load() << " boards in " << seconds.count() << " s" << std::endl;
+	if (failed.load()) {
+		std::cerr << "rendering failed (no software driver, or " << options.output << " is not writable)" << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,454 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#include "gameprotocol.h"
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#ifndef EPOLLEXCLUSIVE
+#define EPOLLEXCLUSIVE (1u << 28)
+#endif
+
+namespace {
+
+// a request line longer than this closes the connection
+const int inputCapacity = 4096;
+// replies waiting for the socket, no more requests are read while it is full
+const int outputCapacity = 16384;
+const int maxEvents = 256;
+
+struct Options {
+	int size = 8;
+	int atoms = 5;
+	int port = 7878;
+	std::string socketPath;
+	int threads = 0;
+	std::string logPrefix;
+};
+
+void usage() {
+	std::cerr << "usage: blackbox-server [-s size] [-a atoms] [-p port | -u socket] [-j threads] [-l log]" << std::endl;
+	std::cerr << "  -p listens on 127.0.0.1 (default port 7878), -u on a unix socket" << std::endl;
+	std::cerr << "  -l records the games of every thread into log.<thread> (see blackbox-stats)" << std::endl;
+	std::cerr << "  one game per connection, see gameprotocol.h for the commands" << std::endl;
+}
+
+// a client and its game, closed connections are kept for the next client
+struct Connection {
+	Connection(int size, int atoms, unsigned int seed): game(size, atoms, seed), protocol(game) {}
+
+	int fd = -1;
+	int inLength = 0;
+	int outLength = 0;
+	// waiting for the socket to take the replies instead of reading requests
+	bool writing = false;
+	// the last reply is sent before closing (quit or an overlong line)
+	bool closing = false;
+	Game game;
+	GameProtocol protocol;
+	char input[inputCapacity];
+	char output[outputCapacity];
+};
+
+// an epoll loop on its own thread, all workers wait on the same listening socket
+// and the kernel wakes one of them per new client
+class Worker {
+public:
+	Worker(const Options& options, int listener, int wakeup, unsigned int seed, int number):
+			options(options), listener(listener), wakeup(wakeup), seeds(seed), clients(0) {
+		if (!options.logPrefix.empty()) {
+			std::string path = options.logPrefix + "." + std::to_string(number);
+			log.reset(new GameLogWriter);
+			if (!log->open(path, options.size)) {
+				throw std::runtime_error("could not open the game log " + path);
+			}
+		}
+		epoll = epoll_create1(EPOLL_CLOEXEC);
+		if (epoll < 0) {
+			throw std::runtime_error("epoll_create1 failed");
+		}
+		epoll_event event = {};
+		event.events = EPOLLIN | EPOLLEXCLUSIVE;
+		// the members tell the events apart, the parameters of the same name are gone after the constructor
+		event.data.ptr = &this->listener;
+		epoll_ctl(epoll, EPOLL_CTL_ADD, listener, &event);
+		event.events = EPOLLIN;
+		event.data.ptr = &this->wakeup;
+		epoll_ctl(epoll, EPOLL_CTL_ADD, wakeup, &event);
+	}
+
+	~Worker() {
+		for (auto & connection : connections) {
+			if (connection->fd >= 0) {
+				::close(connection->fd);
+			}
+			connection->game.record(0);
+		}
+		::close(epoll);
+	}
+
+	void run() {
+		epoll_event events[maxEvents];
+		for (;;) {
+			int count = epoll_wait(epoll, events, maxEvents, -1);
+			if (count < 0 && errno != EINTR) {
+				return;
+			}
+			for (int i = 0; i < count; ++i) {
+				void* source = events[i].data.ptr;
+				if (source == &wakeup) {
+					return;
+				}
+				if (source == &listener) {
+					acceptClients();
+					continue;
+				}
+				Connection& connection = *static_cast<Connection*>(source);
+				if (connection.fd < 0) {
+					// closed by an earlier event of the same batch
+					continue;
+				}
+				if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+					close(connection);
+				} else if (connection.writing) {
+					serve(connection);
+				} else {
+					receive(connection);
+				}
+			}
+		}
+	}
+
+	long totalClients() const {
+		return clients;
+	}
+
+	long totalRequests() const {
+		long requests = 0;
+		for (auto & connection : connections) {
+			requests += connection->protocol.requests();
+		}
+		return requests;
+	}
+
+	long totalGames() const {
+		long games = 0;
+		for (auto & connection : connections) {
+			games += connection->protocol.games();
+		}
+		return games;
+	}
+
+private:
+	void acceptClients() {
+		for (;;) {
+			int fd = accept4(listener, 0, 0, SOCK_NONBLOCK | SOCK_CLOEXEC);
+			if (fd < 0) {
+				// EAGAIN once another worker took the client or none is left
+				return;
+			}
+			int on = 1;
+			setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+
+			if (idle.empty()) {
+				connections.emplace_back(new Connection(options.size, options.atoms, seeds()));
+				idle.push_back(connections.back().get());
+			}
+			Connection& connection = *idle.back();
+			idle.pop_back();
+			connection.fd = fd;
+			connection.inLength = 0;
+			connection.outLength = 0;
+			connection.writing = false;
+			connection.closing = false;
+			connection.game.seed(seeds());
+			connection.game.reset();
+			// the game of the previous client was written when it left
+			connection.game.record(log.get());
+			connection.protocol.reopen();
+			++clients;
+
+			epoll_event event = {};
+			event.events = EPOLLIN;
+			event.data.ptr = &connection;
+			if (epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &event) < 0) {
+				close(connection);
+			}
+		}
+	}
+
+	void receive(Connection& connection) {
+		ssize_t received = recv(connection.fd, connection.input + connection.inLength, inputCapacity - connection.inLength, 0);
+		if (received == 0 || (received < 0 && errno != EAGAIN && errno != EINTR)) {
+			close(connection);
+			return;
+		}
+		if (received > 0) {
+			connection.inLength += received;
+			serve(connection);
+		}
+	}
+
+	// answers the complete request lines as long as the replies fit the output
+	// returns true if it stopped with requests left because the output is full
+	bool answer(Connection& connection) {
+		int start = 0;
+		bool full = false;
+		while (!connection.closing) {
+			char* line = connection.input + start;
+			char* end = static_cast<char*>(std::memchr(line, '\n', connection.inLength - start));
+			if (!end) {
+				if (start == 0 && connection.inLength == inputCapacity) {
+					connection.outLength += std::snprintf(connection.output + connection.outLength, GameProtocol::maxReply, "error line too long\n");
+					connection.closing = true;
+				}
+				break;
+			}
+			if (outputCapacity - connection.outLength < GameProtocol::maxReply) {
+				full = true;
+				break;
+			}
+			*end = '\0';
+			connection.outLength += connection.protocol.handle(line, connection.output + connection.outLength);
+			start = end+1 - connection.input;
+			connection.closing = connection.protocol.closed();
+		}
+		connection.inLength -= start;
+		std::memmove(connection.input, connection.input + start, connection.inLength);
+		return full;
+	}
+
+	// sends as much of the output as the socket takes, returns false on errors
+	bool flush(Connection& connection) {
+		int sent = 0;
+		while (sent < connection.outLength) {
+			ssize_t written = send(connection.fd, connection.output + sent, connection.outLength - sent, MSG_NOSIGNAL);
+			if (written < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				if (errno != EAGAIN) {
+					return false;
+				}
+				break;
+			}
+			sent += written;
+		}
+		connection.outLength -= sent;
+		std::memmove(connection.output, connection.output + sent, connection.outLength);
+		return true;
+	}
+
+	// runs the buffered requests and sends the replies
+	// while the socket does not take them the connection only waits for it to become writable
+	void serve(Connection& connection) {
+		for (;;) {
+			bool full = answer(connection);
+			if (!flush(connection)) {
+				close(connection);
+				return;
+			}
+			if (connection.outLength > 0) {
+				watch(connection, true);
+				return;
+			}
+			if (connection.closing) {
+				close(connection);
+				return;
+			}
+			if (!full) {
+				break;
+			}
+		}
+		watch(connection, false);
+	}
+
+	void watch(Connection& connection, bool writing) {
+		if (connection.writing == writing) {
+			return;
+		}
+		connection.writing = writing;
+		epoll_event event = {};
+		event.events = writing ? EPOLLOUT : EPOLLIN;
+		event.data.ptr = &connection;
+		epoll_ctl(epoll, EPOLL_CTL_MOD, connection.fd, &event);
+	}
+
+	void close(Connection& connection) {
+		epoll_ctl(epoll, EPOLL_CTL_DEL, connection.fd, 0);
+		::close(connection.fd);
+		connection.fd = -1;
+		connection.game.record(0);
+		idle.push_back(&connection);
+	}
+
+	const Options& options;
+	int listener;
+	int wakeup;
+	int epoll;
+	std::mt19937 seeds;
+	long clients;
+	std::vector<std::unique_ptr<Connection>> connections;
+	std::vector<Connection*> idle;
+	std::unique_ptr<GameLogWriter> log;
+};
+
+int listenTcp(int port) {
+	int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (fd < 0) {
+		return -1;
+	}
+	int on = 1;
+	setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+	sockaddr_in address = {};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(fd, SOMAXCONN) < 0) {
+		::close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+int listenUnix(const std::string& path) {
+	sockaddr_un address = {};
+	if (path.size() >= sizeof(address.sun_path)) {
+		return -1;
+	}
+	int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (fd < 0) {
+		return -1;
+	}
+	address.sun_family = AF_UNIX;
+	std::strcpy(address.sun_path, path.c_str());
+	unlink(path.c_str());
+	if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(fd, SOMAXCONN) < 0) {
+		::close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+}
+
+int main(int argc, char** argv) {
+	Options options;
+	for (int i = 1; i < argc; ++i) {
+		if (!std::strcmp(argv[i], "-s") && i+1 < argc) {
+			options.size = std::atoi(argv[++i]);
+		} else if (!std::strcmp(argv[i], "-a") && i+1 < argc) {
+			options.atoms = std::atoi(argv[++i]);
+		} else if (!std::strcmp(argv[i], "-p") && i+1 < argc) {
+			options.port = std::atoi(argv[++i]);
+		} else if (!std::strcmp(argv[i], "-u") && i+1 < argc) {
+			options.socketPath = argv[++i];
+		} else if (!std::strcmp(argv[i], "-j") && i+1 < argc) {
+			options.threads = std::atoi(argv[++i]);
+		} else if (!std::strcmp(argv[i], "-l") && i+1 < argc) {
+			options.logPrefix = argv[++i];
+		} else {
+			usage();
+			return 1;
+		}
+	}
+	try {
+		Game check(options.size, options.atoms, 0);
+	} catch (const std::invalid_argument& error) {
+		std::cerr << error.what() << std::endl;
+		usage();
+		return 1;
+	}
+
+	int listener = options.socketPath.empty() ? listenTcp(options.port) : listenUnix(options.socketPath);
+	if (listener < 0) {
+		std::cerr << "could not listen on " << (options.socketPath.empty() ? "port " + std::to_string(options.port) : options.socketPath) << std::endl;
+		return 1;
+	}
+	// written once on shutdown, every worker sees it readable and stops
+	int wakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+	// the workers leave the signals to the main thread
+	sigset_t signals;
+	sigemptyset(&signals);
+	sigaddset(&signals, SIGINT);
+	sigaddset(&signals, SIGTERM);
+	pthread_sigmask(SIG_BLOCK, &signals, 0);
+
+	unsigned int threads = options.threads > 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+	std::random_device seed;
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::vector<std::thread> running;
+	try {
+		for (unsigned int i = 0; i < threads; ++i) {
+			workers.emplace_back(new Worker(options, listener, wakeup, seed(), i));
+		}
+	} catch (const std::runtime_error& error) {
+		std::cerr << error.what() << std::endl;
+		return 1;
+	}
+	for (auto & worker : workers) {
+		running.emplace_back(&Worker::run, worker.get());
+	}
+	std::cerr << "serving " << options.size << "x" << options.size << " games with " << options.atoms << " atoms on "
+		<< (options.socketPath.empty() ? "127.0.0.1:" + std::to_string(options.port) : options.socketPath)
+		<< " with " << threads << " threads" << std::endl;
+
+	int signal;
+	sigwait(&signals, &signal);
+	std::uint64_t one = 1;
+	if (write(wakeup, &one, sizeof(one)) < 0) {
+		return 1;
+	}
+	long clients = 0;
+	long requests = 0;
+	long games = 0;
+	for (unsigned int i = 0; i < threads; ++i) {
+		running[i].join();
+		clients += workers[i]->totalClients();
+		requests += workers[i]->totalRequests();
+		games += workers[i]->totalGames();
+	}
+	workers.clear();
+	::close(listener);
+	::close(wakeup);
+	if (!options.socketPath.empty()) {
+		unlink(options.socketPath.c_str());
+	}
+	std::cerr << clients << " clients, " << requests << " requests, " << games << " games" << std::endl;
+	return 0;
+}
@@ -0,0 +1,114 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "solver.h"
+#include "notation.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+void usage() {
+	std::cerr << "usage: blackbox-solve [-s size] [-a atoms] [-j threads] [-n shown] [-u] observation..." << std::endl;
+	std::cerr << "  an observation is <raycube>=<outcome>, e.g. L3=hit, B0=reflection or L0=T5" << std::endl;
+	std::cerr << "  raycubes are L, R, B or T followed by their index, - reads observations from stdin" << std::endl;
+	std::cerr << "  -u stops at the second solution (only checks whether the solution is unique)" << std::endl;
+}
+
+// draw a board with x to the right, the same way the cell ids count
+template <class Board>
+void printBoard(const Board& board) {
+	for (int y = board.size()-1; y >= 0; --y) {
+		for (int x = 0; x < board.size(); ++x) {
+			std::cout << (board.hasAtom(x, y) ? 'o' : '.');
+		}
+		std::cout << std::endl;
+	}
+}
+
+template <int Words>
+int solve(int size, int atoms, const std::vector<Observation>& observations, int threads, int shown, bool uniqueOnly) {
+	BasicSolver<Words> solver(size, atoms, observations);
+	typename BasicSolver<Words>::Result result = solver.solve(threads, uniqueOnly ? 2 : 0, shown);
+	std::cout << "solutions: " << result.count << (result.complete ? "" : "+") << std::endl;
+	std::cout << "unique: " << (result.count == 1 ? "yes" : "no") << std::endl;
+	for (auto & board : result.solutions) {
+		std::cout << std::endl;
+		printBoard(board);
+	}
+	return result.count == 1 ? 0 : 2;
+}
+
+}
+
+int main(int argc, char** argv) {
+	int size = 8;
+	int atoms = 5;
+	int threads = 0;
+	int shown = 0;
+	bool uniqueOnly = false;
+	std::vector<std::string> names;
+	for (int i = 1; i < argc; ++i) {
+		if (!std::strcmp(argv[i], "-s") && i+1 < argc) {
+			size = std::atoi(argv[++i]);
+		} else if (!std::strcmp(argv[i], "-a") && i+1 < argc) {
+			atoms = std::atoi(argv[++i]);
+		} else if (!std::strcmp(argv[i], "-j") && i+1 < argc) {
+			threads = std::atoi(argv[++i]);
+		} else if (!std::strcmp(argv[i], "-n") && i+1 < argc) {
+			shown = std::atoi(argv[++i]);
+		} else if (!std::strcmp(argv[i], "-u")) {
+			uniqueOnly = true;
+		} else if (!std::strcmp(argv[i], "-")) {
+			std::string name;
+			while (std::cin >> name) {
+				names.push_back(name);
+			}
+		} else if (argv[i][0] != '-') {
+			names.push_back(argv[i]);
+		} else {
+			usage();
+			return 1;
+		}
+	}
+
+	std::vector<Observation> observations;
+	for (auto & name : names) {
+		std::size_t split = name.find('=');
+		Observation observation;
+		if (split == std::string::npos
+		|| (observation.entry = parseEntry(name.substr(0, split), size)) < 0
+		|| !parseResult(name.substr(split+1), size, observation.result)) {
+			std::cerr << "invalid observation: " << name << std::endl;
+			return 1;
+		}
+		observations.push_back(observation);
+	}
+
+	try {
+		if (size*size <= BlackboxBoard::maxCells) {
+			return solve<1>(size, atoms, observations, threads, shown, uniqueOnly);
+		}
+		return solve<4>(size, atoms, observations, threads, shown, uniqueOnly);
+	} catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+}
@@ -0,0 +1,266 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "solver.h"
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+// the placements below this number of atoms are handed out as tasks, deeper ones are searched in place
+const int splitDepth = 2;
+
+template <int Words>
+class Search {
+public:
+	typedef BasicBlackboxBoard<Words> Board;
+	typedef typename Board::Bits Bits;
+
+	// a partial placement: atoms in cells below next are decided
+	struct Node {
+		Bits atoms;
+		int placed;
+		int next;
+		std::uint64_t pending;	// observations that may still fail
+	};
+
+	struct Worker {
+		std::mutex mutex;
+		std::deque<Node> tasks;
+	};
+
+	Search(int size, int atoms, const std::vector<Observation>& observations, int threads, std::uint64_t limit, std::size_t keep, const std::atomic<bool>* cancel):
+		size(size), cells(size*size), atoms(atoms), observations(observations), limit(limit), keep(keep), cancel(cancel),
+		count(0), outstanding(0), stop(false) {
+		for (int i = 0; i < threads; ++i) {
+			workers.emplace_back(new Worker());
+		}
+	}
+
+	void run() {
+		Node root;
+		root.placed = 0;
+		root.next = 0;
+		root.pending = observations.size() == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << observations.size()) - 1;
+		push(0, root);
+		std::vector<std::thread> threads;
+		for (std::size_t i = 1; i < workers.size(); ++i) {
+			threads.emplace_back(&Search::work, this, i);
+		}
+		work(0);
+		for (auto & thread : threads) {
+			thread.join();
+		}
+	}
+
+	std::uint64_t solutions() const {
+		std::uint64_t n = count.load();
+		return limit && n > limit ? limit : n;
+	}
+
+	bool stopped() const {
+		return stop.load();
+	}
+
+	// stopped at the limit or cancelled from outside
+	bool halted() {
+		if (cancel && cancel->load(std::memory_order_relaxed)) {
+			stop.store(true, std::memory_order_relaxed);
+		}
+		return stop.load(std::memory_order_relaxed);
+	}
+
+	std::vector<Bits> found;
+
+private:
+	void push(std::size_t worker, const Node& node) {
+		outstanding.fetch_add(1);
+		std::lock_guard<std::mutex> lock(workers[worker]->mutex);
+		workers[worker]->tasks.push_back(node);
+	}
+
+	// take the newest own task or steal the oldest (largest) task of another worker
+	bool pop(std::size_t worker, Node& node) {
+		{
+			std::lock_guard<std::mutex> lock(workers[worker]->mutex);
+			if (!workers[worker]->tasks.empty()) {
+				node = workers[worker]->tasks.back();
+				workers[worker]->tasks.pop_back();
+				return true;
+			}
+		}
+		for (std::size_t i = 1; i < workers.size(); ++i) {
+			Worker& victim = *workers[(worker+i) % workers.size()];
+			std::lock_guard<std::mutex> lock(victim.mutex);
+			if (!victim.tasks.empty()) {
+				node = victim.tasks.front();
+				victim.tasks.pop_front();
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void work(std::size_t worker) {
+		Node node;
+		while (!halted()) {
+			if (!pop(worker, node)) {
+				if (outstanding.load() == 0) {
+					break;
+				}
+				std::this_thread::yield();
+				continue;
+			}
+			BasicRayEngine<Words> engine(size);
+			node.atoms.forEach([&](int cell) { engine.addAtom(cell); });
+			search(worker, node, engine);
+			outstanding.fetch_sub(1);
+		}
+	}
+
+	// check the pending observations for a board whose cells below decided are known
+	// returns false if one of them fails, observations that hold are removed from pending
+	bool check(const BasicRayEngine<Words>& engine, int decided, std::uint64_t& pending) const {
+		std::uint64_t open = pending;
+		while (open) {
+			int i = __builtin_ctzll(open);
+			open &= open - 1;
+			RayResult result;
+			if (engine.tracePartial(observations[i].entry, decided, result)) {
+				if (result != observations[i].result) {
+					return false;
+				}
+				pending &= ~(std::uint64_t(1) << i);
+			}
+		}
+		return true;
+	}
+
+	void search(std::size_t worker, const Node& node, const BasicRayEngine<Words>& engine) {
+		if (node.placed == atoms) {
+			std::uint64_t pending = node.pending;
+			if (check(engine, cells, pending)) {
+				solution(node.atoms);
+			}
+			return;
+		}
+		std::uint64_t pending = node.pending;
+		for (int cell = node.next; cell <= cells - (atoms - node.placed); ++cell) {
+			if (halted()) {
+				return;
+			}
+			// cells up to here stay empty: an observation failing now fails for every later cell too
+			if (!check(engine, cell, pending)) {
+				return;
+			}
+			Node child;
+			child.atoms = node.atoms;
+			child.atoms.set(cell);
+			child.placed = node.placed + 1;
+			child.next = cell + 1;
+			child.pending = pending;
+			BasicRayEngine<Words> childEngine(engine);
+			childEngine.addAtom(cell);
+			if (!check(childEngine, cell+1, child.pending)) {
+				continue;
+			}
+			if (child.placed < splitDepth && child.placed < atoms) {
+				push(worker, child);
+			} else {
+				search(worker, child, childEngine);
+			}
+		}
+	}
+
+	void solution(const Bits& bits) {
+		std::uint64_t n = count.fetch_add(1) + 1;
+		if (keep) {
+			std::lock_guard<std::mutex> lock(foundMutex);
+			if (found.size() < keep) {
+				found.push_back(bits);
+			}
+		}
+		if (limit && n >= limit) {
+			stop.store(true);
+		}
+	}
+
+	const int size;
+	const int cells;
+	const int atoms;
+	const std::vector<Observation>& observations;
+	const std::uint64_t limit;
+	const std::size_t keep;
+	const std::atomic<bool>* cancel;
+
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::atomic<std::uint64_t> count;
+	std::atomic<long> outstanding;
+	std::atomic<bool> stop;
+	std::mutex foundMutex;
+};
+
+}
+
+template <int Words>
+BasicSolver<Words>::BasicSolver(int size, int atoms, const std::vector<Observation>& observations):
+	boardSize(size), atomCount(atoms), observations(observations) {
+	// checks the size
+	Board board(size);
+	if (atoms < 0 || atoms > board.cells()) {
+		throw std::invalid_argument("atom count does not fit the board");
+	}
+	if (observations.size() > 64) {
+		throw std::invalid_argument("too many observations");
+	}
+	for (auto & observation : observations) {
+		if (observation.entry < 0 || observation.entry >= 4*size
+		|| (observation.result.outcome == RAY_EXIT && (observation.result.exit < 0 || observation.result.exit >= 4*size))) {
+			throw std::invalid_argument("observation outside of the board");
+		}
+	}
+}
+
+template <int Words>
+typename BasicSolver<Words>::Result BasicSolver<Words>::solve(int threads, std::uint64_t limit, std::size_t keep, const std::atomic<bool>* cancel) const {
+	if (threads <= 0) {
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	Search<Words> search(boardSize, atomCount, observations, threads, limit, keep, cancel);
+	search.run();
+
+	Result result;
+	result.count = search.solutions();
+	result.complete = !search.stopped();
+	std::sort(search.found.begin(), search.found.end(), [](const Bitboard<Words>& a, const Bitboard<Words>& b) { return a.words < b.words; });
+	for (auto & bits : search.found) {
+		Board board(boardSize);
+		bits.forEach([&](int cell) { board.setAtom(cell); });
+		result.solutions.push_back(board);
+	}
+	return result;
+}
+
+template class BasicSolver<1>;
+template class BasicSolver<4>;
+template class BasicSolver<16>;
+template class BasicSolver<64>;
@@ -0,0 +1,69 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BLACKBOX_SOLVER_H
+#define BLACKBOX_SOLVER_H
+
+#include "rayengine.h"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// an outcome the player has seen for a raycube
+struct Observation {
+	int entry;
+	RayResult result;
+	Observation(int entry = 0, const RayResult& result = RayResult()): entry(entry), result(result) {}
+};
+
+// finds all atom placements that lead to a given set of observations
+// atoms are placed in ascending cell order and a placement is dropped as soon as a ray that only
+// runs through already decided cells disagrees with its observation
+// the search tree is split into tasks that idle threads steal from each other
+template <int Words>
+class BasicSolver {
+public:
+	typedef BasicBlackboxBoard<Words> Board;
+
+	struct Result {
+		std::uint64_t count;	// number of solutions (capped at the limit)
+		bool complete;			// false if the search stopped at the limit
+		std::vector<Board> solutions;	// the first solutions found, sorted
+	};
+
+	BasicSolver(int size, int atoms, const std::vector<Observation>& observations);
+
+	// threads = 0 uses all cores, limit = 0 counts all solutions, keep is the number of solutions to return
+	// the search gives up (incomplete) as soon as cancel is set
+	Result solve(int threads = 0, std::uint64_t limit = 0, std::size_t keep = 0, const std::atomic<bool>* cancel = 0) const;
+
+	// whether exactly one placement fits the observations (stops at the second one)
+	bool unique(int threads = 0) const {
+		return solve(threads, 2).count == 1;
+	}
+
+private:
+	int boardSize;
+	int atomCount;
+	std::vector<Observation> observations;
+};
+
+typedef BasicSolver<1> Solver;
+typedef BasicSolver<4> WideSolver;
+// also built for 16 and 64 words, see HintEngine
+
+#endif
@@ -0,0 +1,304 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "game.h"
+#include "gamelog.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct Options {
+	int threads = 0;
+	bool replay = false;
+	bool distribution = false;
+	std::vector<std::string> logs;
+};
+
+void usage() {
+	std::cerr << "usage: blackbox-stats [-j threads] [-r] [-d] log..." << std::endl;
+	std::cerr << "  -r replays every game through the game engine and counts the games that disagree with their log" << std::endl;
+	std::cerr << "  -d prints the full penalty distribution of every board size and atom count" << std::endl;
+}
+
+// aggregates of the evaluated games of one board size and atom count
+struct Group {
+	std::uint64_t games = 0;
+	std::uint64_t rays = 0;
+	std::uint64_t found = 0;
+	// number of games per penalty
+	std::vector<std::uint64_t> penalties;
+
+	void add(const Group& other) {
+		games += other.games;
+		rays += other.rays;
+		found += other.found;
+		if (penalties.size() < other.penalties.size()) {
+			penalties.resize(other.penalties.size());
+		}
+		for (std::size_t p = 0; p < other.penalties.size(); ++p) {
+			penalties[p] += other.penalties[p];
+		}
+	}
+
+	// smallest penalty that at least the given part of the games reached
+	int percentile(double part) const {
+		std::uint64_t rank = part*games, seen = 0;
+		for (std::size_t p = 0; p < penalties.size(); ++p) {
+			seen += penalties[p];
+			if (seen > rank || seen == games) {
+				return p;
+			}
+		}
+		return 0;
+	}
+};
+
+// keyed by board size and number of atoms
+typedef std::map<std::pair<int, int>, Group> Groups;
+
+struct Totals {
+	std::uint64_t logs = 0;
+	std::uint64_t games = 0;
+	std::uint64_t rays = 0;
+	std::uint64_t moves = 0;
+	std::uint64_t mismatches = 0;
+	std::vector<std::string> failed;
+	Groups groups;
+
+	void add(const Totals& other) {
+		logs += other.logs;
+		games += other.games;
+		rays += other.rays;
+		moves += other.moves;
+		mismatches += other.mismatches;
+		failed.insert(failed.end(), other.failed.begin(), other.failed.end());
+		for (auto & group : other.groups) {
+			groups[group.first].add(group.second);
+		}
+	}
+};
+
+// follows the games of one log in a single pass over its events
+class LogScanner {
+public:
+	LogScanner(Totals& totals, bool replay): totals(totals), replay(replay), group(0) {}
+
+	bool scan(const std::string& path) {
+		GameLogReader reader;
+		if (!reader.open(path)) {
+			return false;
+		}
+		size = reader.size();
+		hidden.assign(size*size, 0);
+		guesses.assign(size*size, 0);
+		std::unique_ptr<Game> game;
+		std::unique_ptr<GameLogReplay> replayer;
+		if (replay) {
+			game.reset(new Game(size, 0, 0));
+			replayer.reset(new GameLogReplay(*game));
+		}
+		started = false;
+		agrees = true;
+		GameLogEvent event;
+		while (reader.next(event)) {
+			switch (event.type) {
+				case LOG_GAME:
+					finish();
+					start(event);
+					break;
+				case LOG_RAY:
+					++rays;
+					break;
+				case LOG_PLACE:
+				case LOG_REMOVE:
+					if (event.value < size*size) {
+						guesses[event.value] = event.type == LOG_PLACE;
+					}
+					++totals.moves;
+					break;
+				case LOG_EVALUATE:
+					penalty = event.value;
+					found = 0;
+					for (int cell = 0; cell < size*size; ++cell) {
+						found += hidden[cell] && guesses[cell];
+					}
+					break;
+			}
+			if (replayer && started) {
+				agrees = replayer->play(event) && agrees;
+			}
+		}
+		finish();
+		++totals.logs;
+		return !reader.corrupt();
+	}
+
+private:
+	void start(const GameLogEvent& event) {
+		std::fill(hidden.begin(), hidden.end(), 0);
+		std::fill(guesses.begin(), guesses.end(), 0);
+		for (int i = 0; i < event.value; ++i) {
+			if (event.atom(i) < size*size) {
+				hidden[event.atom(i)] = 1;
+			}
+		}
+		group = &totals.groups[std::make_pair(size, event.value)];
+		started = true;
+		agrees = true;
+		rays = 0;
+		penalty = -1;
+		found = 0;
+	}
+
+	void finish() {
+		if (!started) {
+			return;
+		}
+		++totals.games;
+		totals.rays += rays;
+		totals.mismatches += !agrees;
+		// games that were never evaluated have no final penalty
+		if (penalty >= 0) {
+			++group->games;
+			group->rays += rays;
+			group->found += found;
+			if (group->penalties.size() <= static_cast<std::size_t>(penalty)) {
+				group->penalties.resize(penalty+1);
+			}
+			++group->penalties[penalty];
+		}
+		started = false;
+	}
+
+	Totals& totals;
+	bool replay;
+	int size;
+	std::vector<char> hidden;
+	std::vector<char> guesses;
+	Group* group;
+	bool started;
+	bool agrees;
+	int rays;
+	int penalty;
+	int found;
+};
+
+}
+
+int main(int argc, char** argv) {
+	Options options;
+	for (int i = 1; i < argc; ++i) {
+		if (!std::strcmp(argv[i], "-j") && i+1 < argc) {
+			options.threads = std::atoi(argv[++i]);
+		} else if (!std::strcmp(argv[i], "-r")) {
+			options.replay = true;
+		} else if (!std::strcmp(argv[i], "-d")) {
+			options.distribution = true;
+		} else if (argv[i][0] == '-') {
+			usage();
+			return 1;
+		} else {
+			options.logs.push_back(argv[i]);
+		}
+	}
+	if (options.logs.empty()) {
+		usage();
+		return 1;
+	}
+
+	// every thread takes the next log until none are left and merges its totals at the end
+	auto start = std::chrono::steady_clock::now();
+	Totals totals;
+	std::mutex totalsMutex;
+	std::atomic<std::size_t> nextLog(0);
+	auto work = [&]() {
+		Totals own;
+		LogScanner scanner(own, options.replay);
+		for (std::size_t i = nextLog.fetch_add(1); i < options.logs.size(); i = nextLog.fetch_add(1)) {
+			if (!scanner.scan(options.logs[i])) {
+				own.failed.push_back(options.logs[i]);
+			}
+		}
+		std::lock_guard<std::mutex> lock(totalsMutex);
+		totals.add(own);
+	};
+	unsigned int threads = options.threads > 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+	threads = std::min<std::size_t>(threads, options.logs.size());
+	std::vector<std::thread> workers;
+	for (unsigned int i = 1; i < threads; ++i) {
+		workers.emplace_back(work);
+	}
+	work();
+	for (auto & worker : workers) {
+		worker.join();
+	}
+	std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+
+	for (auto & path : totals.failed) {
+		std::cerr << "could not read " << path << " (missing, no game log or truncated)" << std::endl;
+	}
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << totals.games << " games in " << totals.logs << " logs, "
+		<< (totals.games ? double(totals.rays) / totals.games : 0.0) << " rays and "
+		<< (totals.games ? double(totals.moves) / totals.games : 0.0) << " atom moves per game" << std::endl;
+	if (options.replay) {
+		std::cout << totals.mismatches << " games disagree with the engine" << std::endl;
+	}
+	std::cout << "size atoms   games   rays  found  penalty (mean  min  p50  p90  max)" << std::endl;
+	for (auto & entry : totals.groups) {
+		const Group& group = entry.second;
+		if (group.games == 0) {
+			continue;
+		}
+		std::uint64_t sum = 0;
+		int least = -1, most = 0;
+		for (std::size_t p = 0; p < group.penalties.size(); ++p) {
+			sum += p*group.penalties[p];
+			if (group.penalties[p]) {
+				least = least < 0 ? p : least;
+				most = p;
+			}
+		}
+		std::cout << std::setw(4) << entry.first.first << std::setw(6) << entry.first.second << std::setw(8) << group.games
+			<< std::setw(7) << double(group.rays) / group.games << std::setw(7) << double(group.found) / group.games
+			<< std::setw(15) << double(sum) / group.games << std::setw(5) << least << std::setw(5) << group.percentile(0.5)
+			<< std::setw(5) << group.percentile(0.9) << std::setw(5) << most << std::endl;
+		if (options.distribution) {
+			for (std::size_t p = 0; p < group.penalties.size(); ++p) {
+				if (group.penalties[p]) {
+					std::cout << "    penalty " << std::setw(4) << p << ": " << group.penalties[p] << std::endl;
+				}
+			}
+		}
+	}
+	std::cerr << totals.games << " games in " << seconds.count() << " s" << std::endl;
+	return totals.failed.empty() ? 0 : 1;
+}
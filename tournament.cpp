@@ -0,0 +1,140 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "tournament.h"
+#include "boardview.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace irr;
+
+namespace {
+// room of a board: its cubes, the raycubes five units outside of them and a gap
+float boardPitch(int size) {
+	return 3*size + 14;
+}
+
+// the boards draw their atoms from the streams after the ones of the colors and the hints (see main.cpp)
+const std::uint64_t firstBoardStream = 3;
+}
+
+Tournament::Tournament(scene::ISceneManager* smgr, int boards, int size, scene::IMesh* cube, scene::IMesh* atom, std::uint64_t seed, int threads):
+	pending(boards, Pending{false, false, true}), picker(size, -(3*size)/2, cube->getBoundingBox().getExtent().X/2),
+	pool(std::min(threads > 0 ? threads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency())), boards)), size(size) {
+	columns = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(boards))));
+	rows = (boards + columns-1) / columns;
+	active.reserve(boards);
+	const float pitch = boardPitch(size);
+	for (int board = 0; board < boards; ++board) {
+		// every board draws its own atoms (from a stream of the seed of its own)
+		games.emplace_back(new Game(size, Game::defaultAtoms, seed, firstBoardStream + board));
+		BoardSceneNode* node = new BoardSceneNode(smgr->getRootSceneNode(), smgr, size, -(3*size)/2, cube, atom, cubeColor, raycubeColor, atomColor);
+		// rows from the top of the screen (along X), columns across it (along Z)
+		int row = board / columns;
+		int column = board % columns;
+		node->setPosition(core::vector3df(((rows-1)/2.0f - row)*pitch, 0, (column - (columns-1)/2.0f)*pitch));
+		node->updateAbsolutePosition();
+		nodes.push_back(node);
+		node->drop();
+	}
+}
+
+float Tournament::cameraDistance() const {
+	// the distance for a single board scaled to the side of the grid
+	return ::cameraDistance(size) * std::max(columns, rows) * boardPitch(size) / (3*size + 10);
+}
+
+void Tournament::resetAll() {
+	for (auto & p : pending) {
+		p.reset = true;
+		p.evaluate = false;
+	}
+}
+
+void Tournament::evaluateAll() {
+	for (int board = 0; board < boards(); ++board) {
+		if (!games[board]->evaluated()) {
+			pending[board].evaluate = true;
+		}
+	}
+}
+
+void Tournament::moreAtoms() {
+	for (auto & game : games) {
+		game->moreAtoms();
+	}
+}
+
+void Tournament::fewerAtoms() {
+	for (auto & game : games) {
+		game->fewerAtoms();
+	}
+}
+
+int Tournament::click(const core::line3df& ray, bool left) {
+	for (int board = 0; board < boards(); ++board) {
+		// the picker knows a board at the origin, so the ray is moved instead of the board
+		const core::vector3df position = nodes[board]->getAbsolutePosition();
+		BoardPicker::Pick pick = picker.pick(core::line3df(ray.start - position, ray.end - position));
+		if (pick.kind == BoardPicker::PICK_NONE) {
+			continue;
+		}
+		Game& game = *games[board];
+		bool changed = false;
+		if (pick.kind == BoardPicker::PICK_RAYCUBE && left) {
+			changed = game.fire(pick.index);
+		} else if (pick.kind == BoardPicker::PICK_CELL) {
+			changed = left ? game.placeAtom(pick.index) : game.removeAtom(pick.index);
+		}
+		pending[board].show = pending[board].show || changed;
+		return board;
+	}
+	return -1;
+}
+
+bool Tournament::update() {
+	active.clear();
+	for (int board = 0; board < boards(); ++board) {
+		const Pending& p = pending[board];
+		if (p.reset || p.evaluate || p.show) {
+			active.push_back(board);
+		}
+	}
+	// every task only touches its own game and node, the nodes upload their colours when they are drawn
+	auto task = [this](int i) {
+		const int board = active[i];
+		Pending& p = pending[board];
+		Game& game = *games[board];
+		if (p.reset) {
+			game.reset();
+		}
+		if (p.evaluate) {
+			game.evaluate();
+		}
+		showGame(game, nodes[board]);
+		p = Pending{false, false, false};
+	};
+	pool.run(static_cast<int>(active.size()), task);
+
+	bool changed = false;
+	for (BoardSceneNode* node : nodes) {
+		if (node->takeChanged()) {
+			changed = true;
+		}
+	}
+	return changed;
+}
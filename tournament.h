@@ -0,0 +1,87 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BLACKBOX_TOURNAMENT_H
+#define BLACKBOX_TOURNAMENT_H
+
+#include <irrlicht.h>
+#include "boardnode.h"
+#include "game.h"
+#include "picker.h"
+#include "workerpool.h"
+#include <memory>
+#include <vector>
+
+// independent games on boards of the same size side by side in one scene, seen by a single camera
+// all boards are built from the same cube and atom meshes and drawn by one drawAll (two draw calls each),
+// so more boards only add draw calls instead of whole frames; the work of the boards (new atoms,
+// evaluation and the colours of the nodes) is queued and done on a worker pool, one task per board
+class Tournament {
+public:
+	// the boards are tiled in rows, screen up is along X like the view of the single board
+	Tournament(irr::scene::ISceneManager* smgr, int boards, int size, irr::scene::IMesh* cube, irr::scene::IMesh* atom,
+		std::uint64_t seed, int threads = 0);
+
+	int boards() const {
+		return static_cast<int>(games.size());
+	}
+
+	Game& game(int board) {
+		return *games[board];
+	}
+
+	BoardSceneNode* node(int board) {
+		return nodes[board];
+	}
+
+	// distance of a camera on the Y axis that sees all boards
+	float cameraDistance() const;
+
+	// queue a new game or the evaluation on every board
+	void resetAll();
+	void evaluateAll();
+	// more or fewer atoms for the next games of every board
+	void moreAtoms();
+	void fewerAtoms();
+
+	// a mouse click: fires the raycube or places (removes) the atom below the ray on whichever board it hits,
+	// returns the board or -1
+	int click(const irr::core::line3df& ray, bool left);
+
+	// do the queued work of all boards on the pool, returns whether any board has to be drawn again
+	bool update();
+
+private:
+	struct Pending {
+		bool reset;
+		bool evaluate;
+		bool show;
+	};
+
+	std::vector<std::unique_ptr<Game>> games;
+	std::vector<BoardSceneNode*> nodes;
+	std::vector<Pending> pending;
+	// boards with queued work in this update
+	std::vector<int> active;
+	BoardPicker picker;
+	WorkerPool pool;
+	int size;
+	int columns;
+	int rows;
+};
+
+#endif
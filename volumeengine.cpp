@@ -0,0 +1,133 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "volumeengine.h"
+
+namespace {
+// the axes across the faces of the given axis, in the order they make up the index of an entry
+const int crossAxes[3][2] = {{1, 2}, {0, 2}, {0, 1}};
+}
+
+template <int Words>
+BasicVolumeRayEngine<Words>::BasicVolumeRayEngine(int size): volumeSize(size) {
+}
+
+template <int Words>
+void BasicVolumeRayEngine<Words>::update(const Bits& atomBits) {
+	const int n = volumeSize;
+	atoms = atomBits;
+	nearAtom.clear();
+	atomBits.forEach([&](int cell) {
+		int p[3] = {cell / (n*n), cell / n % n, cell % n};
+		nearAtom.set(cell);
+		for (int axis = 0; axis < 3; ++axis) {
+			for (int delta = -1; delta <= 1; delta += 2) {
+				p[axis] += delta;
+				if (p[axis] >= 0 && p[axis] < n) {
+					nearAtom.set(cellId(p));
+				}
+				p[axis] -= delta;
+			}
+		}
+	});
+}
+
+template <int Words>
+RayResult BasicVolumeRayEngine<Words>::trace(int entry) const {
+	const int n = volumeSize;
+	const int face = entry / (n*n);
+	const int index = entry % (n*n);
+
+	// init variables dependent on the raycube clicked
+	int axis = face / 2;
+	int incrementor = face % 2 == 0 ? 1 : -1;
+	int p[3];
+	p[axis] = incrementor > 0 ? 0 : n-1;
+	p[crossAxes[axis][0]] = index / n;
+	p[crossAxes[axis][1]] = index % n;
+
+	// if atom next to the first cell: reflect
+	for (int other = 0; other < 3; ++other) {
+		if (other != axis && (atomBeside(p, other, 1) || atomBeside(p, other, -1))) {
+			return RayResult(RAY_REFLECTION);
+		}
+	}
+
+	// a ray visits every cell in every direction at most once, more steps mean a loop
+	for (int steps = 6*n*n*n+6; steps > 0; --steps) {
+		// if border reached: leave through the raycube there
+		if (p[axis] < 0 || p[axis] >= n) {
+			int exitFace = 2*axis + (p[axis] < 0 ? 0 : 1);
+			int exit = exitFace*n*n + p[crossAxes[axis][0]]*n + p[crossAxes[axis][1]];
+			if (exit == entry) {
+				return RayResult(RAY_REFLECTION);
+			}
+			return RayResult(RAY_EXIT, exit);
+		}
+
+		// nothing to check away from atoms
+		if (!nearAtom.test(cellId(p))) {
+			p[axis] += incrementor;
+			continue;
+		}
+
+		// if atom in straight path: hit
+		if (atoms.test(cellId(p))) {
+			return RayResult(RAY_HIT);
+		}
+
+		// if atom next to the path: step back and change path away from it (deflect), then look at that cell
+		// again in the new direction; atoms on both sides of an axis or beside two axes leave no way to turn
+		// to, the ray goes back (on the flat board this is exactly what BasicRayEngine does)
+		int turnAxis = -1;
+		int turnDelta = 0;
+		bool back = false;
+		for (int other = 0; other < 3; ++other) {
+			if (other == axis) {
+				continue;
+			}
+			bool plus = atomBeside(p, other, 1);
+			bool minus = atomBeside(p, other, -1);
+			if (plus && minus) {
+				back = true;
+			} else if (plus || minus) {
+				back = back || turnAxis >= 0;
+				turnAxis = other;
+				turnDelta = plus ? -1 : 1;
+			}
+		}
+		if (back) {
+			p[axis] -= incrementor;
+			incrementor *= -1;
+			continue;
+		}
+		if (turnAxis >= 0) {
+			p[axis] -= incrementor;
+			axis = turnAxis;
+			incrementor = turnDelta;
+			continue;
+		}
+
+		// next step of ray
+		p[axis] += incrementor;
+	}
+	return RayResult(RAY_REFLECTION);
+}
+
+template class BasicVolumeRayEngine<1>;
+template class BasicVolumeRayEngine<8>;
+template class BasicVolumeRayEngine<64>;
@@ -0,0 +1,105 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BLACKBOX_VOLUMEENGINE_H
+#define BLACKBOX_VOLUMEENGINE_H
+
+#include "bitboard.h"
+#include "rayengine.h"
+
+// largest supported volume (16x16x16 cells in 64 words)
+const int maxVolumeSize = 16;
+
+// the faces of a volume rays can enter from
+// the first four are the sides of the flat board, a ray entry (or exit) is identified by face*size*size+index,
+// where index is a*size+b for the two coordinates across the face in axis order (y, z for the x faces)
+enum VolumeFace {
+	FACE_LEFT = 0,	// enters at x = 0 moving along x
+	FACE_RIGHT,		// enters at x = size-1 moving against x
+	FACE_BOTTOM,	// enters at y = 0 moving along y
+	FACE_TOP,		// enters at y = size-1 moving against y
+	FACE_FRONT,		// enters at z = 0 moving along z
+	FACE_BACK		// enters at z = size-1 moving against z
+};
+
+// traces rays through a cube of cells with the rules of the flat board:
+// an atom straight ahead is a hit, an atom next to the path turns the ray away from it, atoms on both
+// sides of an axis (or beside two axes) send it back, and an atom next to the first cell reflects it
+// cell ids are (x*size+y)*size+z, so a volume whose atoms all lie on z = 0 traces its rays on that
+// plane just like BasicRayEngine does on the flat board
+// unlike there, a ray that leaves through another raycube does not always come back the same way:
+// the way back can pass atoms beside two axes where the way there only passed one of them
+// like the flat engine, the cells holding or touching an atom are kept in a mask, so a free step is
+// a single bit test and only the cells next to atoms look at their four neighbours
+template <int Words>
+class BasicVolumeRayEngine {
+public:
+	typedef Bitboard<Words> Bits;
+
+	// an engine for an empty volume of the given size
+	explicit BasicVolumeRayEngine(int size);
+
+	// recompute the masks for a new set of atoms
+	void update(const Bits& atomBits);
+
+	int size() const {
+		return volumeSize;
+	}
+
+	int cells() const {
+		return volumeSize*volumeSize*volumeSize;
+	}
+
+	int entryCount() const {
+		return 6*volumeSize*volumeSize;
+	}
+
+	// shoot a ray from the given entry (face*size*size+index)
+	RayResult trace(int entry) const;
+
+private:
+	// whether there is an atom at p (outside of the volume there never is)
+	bool atomAt(const int* p) const {
+		for (int axis = 0; axis < 3; ++axis) {
+			if (p[axis] < 0 || p[axis] >= volumeSize) {
+				return false;
+			}
+		}
+		return atoms.test(cellId(p));
+	}
+
+	// whether there is an atom next to p along the axis (delta is 1 or -1)
+	bool atomBeside(int* p, int axis, int delta) const {
+		p[axis] += delta;
+		bool atom = atomAt(p);
+		p[axis] -= delta;
+		return atom;
+	}
+
+	int cellId(const int* p) const {
+		return (p[0]*volumeSize + p[1])*volumeSize + p[2];
+	}
+
+	int volumeSize;
+	Bits atoms;
+	// atoms and their direct neighbours, a ray may only change course on these cells
+	Bits nearAtom;
+};
+
+typedef BasicVolumeRayEngine<64> VolumeRayEngine;
+
+#endif
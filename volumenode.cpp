@@ -0,0 +1,304 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "volumenode.h"
+
+using namespace irr;
+
+namespace {
+// distance between neighbouring cubes and between the border cubes and their raycubes (as on the flat board)
+const float cubeSpacing = 3;
+const float raycubeDistance = 5;
+// size of the lattice cubes relative to the cells of the layer
+const f32 latticeScale = 0.3f;
+}
+
+VolumeSceneNode::VolumeSceneNode(scene::ISceneNode* parent, scene::ISceneManager* mgr, int size, float offset,
+	scene::IMesh* cube, scene::IMesh* atom, video::SColor cubeColor, video::SColor raycubeColor, video::SColor atomColor):
+	scene::ISceneNode(parent, mgr), volumeSize(size), volumeOffset(offset), currentLayer(0),
+	atomVisible(size*size*size, false), atomsDirty(true),
+	cellColors(size*size*size, cubeColor), raycubeColors(6*size*size, raycubeColor), changed(true) {
+	cubeScale = cube->getBoundingBox().getExtent().X/2;
+	layerCubes = new scene::CDynamicMeshBuffer(video::EVT_STANDARD, video::EIT_32BIT);
+	lattice = new scene::CDynamicMeshBuffer(video::EVT_STANDARD, video::EIT_32BIT);
+	atoms = new scene::CDynamicMeshBuffer(video::EVT_STANDARD, video::EIT_32BIT);
+
+	// the material of the flat board, the ambient colour comes from the vertices
+	for (scene::CDynamicMeshBuffer* buffer : {layerCubes, lattice, atoms}) {
+		video::SMaterial& material = buffer->getMaterial();
+		material = (buffer == atoms ? atom : cube)->getMeshBuffer(0)->getMaterial();
+		material.setFlag(video::EMF_LIGHTING, true);
+		material.setFlag(video::EMF_BILINEAR_FILTER, false);
+		material.Shininess = 20.0f;
+		material.ColorMaterial = video::ECM_AMBIENT;
+	}
+
+	cubeVertices = 0;
+	for (u32 i = 0; i < cube->getMeshBufferCount(); ++i) {
+		cubeVertices += cube->getMeshBuffer(i)->getVertexCount();
+	}
+
+	// the layer at z = 0: cells (x*size+y), the raycubes of the sides (side*size+index), then the front
+	// and the back panel (in cell order), it is moved to the current layer when drawn
+	const int area = size*size;
+	box.reset(getLayerPosition(0));
+	for (int cell = 0; cell < area; ++cell) {
+		addInstance(layerCubes, cube, getLayerPosition(cell), 1, cubeColor);
+	}
+	for (int side = 0; side < 4; ++side) {
+		for (int index = 0; index < size; ++index) {
+			core::vector3df position;
+			if (side == 0) {
+				position = getLayerPosition(index) + core::vector3df(0,0,-raycubeDistance);
+			} else if (side == 1) {
+				position = getLayerPosition((size-1)*size+index) + core::vector3df(0,0,raycubeDistance);
+			} else if (side == 2) {
+				position = getLayerPosition(index*size) + core::vector3df(-raycubeDistance,0,0);
+			} else {
+				position = getLayerPosition(index*size+size-1) + core::vector3df(raycubeDistance,0,0);
+			}
+			addInstance(layerCubes, cube, position, 1, raycubeColor);
+		}
+	}
+	for (int panel = 0; panel < 2; ++panel) {
+		const core::vector3df shift(0,0, panel == 0 ? -panelShift(size) : panelShift(size));
+		for (int cell = 0; cell < area; ++cell) {
+			addInstance(layerCubes, cube, getLayerPosition(cell) + shift, 1, raycubeColor);
+		}
+	}
+	// the layer may be moved to the back of the volume
+	core::aabbox3df layerBox = box;
+	layerBox.MinEdge.Y += layerSpacing()*(size-1);
+	layerBox.MaxEdge.Y += layerSpacing()*(size-1);
+	box.addInternalBox(layerBox);
+
+	for (int cell = 0; cell < area*size; ++cell) {
+		addInstance(lattice, cube, getCellPosition(cell), latticeScale, cubeColor);
+	}
+
+	// only visible atoms are in the atom buffer, it is rebuilt from a single atom at the origin
+	addInstance(atoms, atom, core::vector3df(0,-1,0), 1, atomColor);
+	scene::IVertexBuffer& vertices = atoms->getVertexBuffer();
+	scene::IIndexBuffer& indices = atoms->getIndexBuffer();
+	for (u32 i = 0; i < vertices.size(); ++i) {
+		atomVertices.push_back(vertices[i]);
+	}
+	for (u32 i = 0; i < indices.size(); ++i) {
+		atomIndices.push_back(indices[i]);
+	}
+	vertices.set_used(0);
+	indices.set_used(0);
+
+	for (scene::CDynamicMeshBuffer* buffer : {layerCubes, lattice, atoms}) {
+		buffer->setBoundingBox(box);
+		buffer->setHardwareMappingHint(scene::EHM_STATIC);
+	}
+}
+
+VolumeSceneNode::~VolumeSceneNode() {
+	layerCubes->drop();
+	lattice->drop();
+	atoms->drop();
+}
+
+float VolumeSceneNode::layerSpacing() {
+	return cubeSpacing;
+}
+
+float VolumeSceneNode::panelShift(int size) {
+	return cubeSpacing*size + 2*raycubeDistance;
+}
+
+core::vector3df VolumeSceneNode::getLayerPosition(int cell) const {
+	int x = cell % volumeSize;
+	int y = cell / volumeSize;
+	return core::vector3df(volumeOffset + cubeSpacing*x + cubeScale, 0, volumeOffset + cubeSpacing*y + cubeScale + 0.5f);
+}
+
+core::vector3df VolumeSceneNode::getCellPosition(int cell) const {
+	return getLayerPosition(cell / volumeSize) + core::vector3df(0, layerSpacing()*(cell % volumeSize), 0);
+}
+
+int VolumeSceneNode::layerInstance(int entry) const {
+	const int area = volumeSize*volumeSize;
+	const int face = entry / area;
+	const int index = entry % area;
+	if (face < 4) {
+		// index is a*size+z on the side faces
+		if (index % volumeSize != currentLayer) {
+			return -1;
+		}
+		return area + face*volumeSize + index / volumeSize;
+	}
+	return area + 4*volumeSize + (face-4)*area + index;
+}
+
+void VolumeSceneNode::addInstance(scene::CDynamicMeshBuffer* buffer, scene::IMesh* mesh, const core::vector3df& position, f32 scale, video::SColor color) {
+	// correct Blender rotation for Irrlicht like the flat board
+	// (setScale would overwrite the rotation, so the scale is applied on its own)
+	core::matrix4 rotation;
+	rotation.setRotationDegrees(core::vector3df(0,0,180));
+
+	scene::IVertexBuffer& vertices = buffer->getVertexBuffer();
+	scene::IIndexBuffer& indices = buffer->getIndexBuffer();
+	for (u32 i = 0; i < mesh->getMeshBufferCount(); ++i) {
+		scene::IMeshBuffer* source = mesh->getMeshBuffer(i);
+		const video::S3DVertex* sourceVertices = static_cast<const video::S3DVertex*>(source->getVertices());
+		const u32 first = vertices.size();
+		for (u32 v = 0; v < source->getVertexCount(); ++v) {
+			video::S3DVertex vertex = sourceVertices[v];
+			rotation.rotateVect(vertex.Pos);
+			vertex.Pos = vertex.Pos*scale + position;
+			rotation.rotateVect(vertex.Normal);
+			vertex.Color = color;
+			vertices.push_back(vertex);
+			box.addInternalPoint(vertex.Pos);
+		}
+		for (u32 j = 0; j < source->getIndexCount(); ++j) {
+			indices.push_back(first + source->getIndices()[j]);
+		}
+	}
+}
+
+void VolumeSceneNode::setInstanceColor(scene::CDynamicMeshBuffer* buffer, int instance, video::SColor color) {
+	scene::IVertexBuffer& vertexBuffer = buffer->getVertexBuffer();
+	for (u32 v = instance*cubeVertices; v < (instance+1)*cubeVertices; ++v) {
+		vertexBuffer[v].Color = color;
+	}
+	buffer->setDirty(scene::EBT_VERTEX);
+}
+
+void VolumeSceneNode::setLayer(int layer) {
+	if (layer == currentLayer || layer < 0 || layer >= volumeSize) {
+		return;
+	}
+	currentLayer = layer;
+	const int area = volumeSize*volumeSize;
+	for (int cell = 0; cell < area; ++cell) {
+		setInstanceColor(layerCubes, cell, cellColors[cell*volumeSize + layer]);
+	}
+	for (int side = 0; side < 4; ++side) {
+		for (int index = 0; index < volumeSize; ++index) {
+			setInstanceColor(layerCubes, area + side*volumeSize + index, raycubeColors[side*area + index*volumeSize + layer]);
+		}
+	}
+	changed = true;
+}
+
+void VolumeSceneNode::setCubeColor(int cell, video::SColor color) {
+	if (cellColors[cell] == color) {
+		return;
+	}
+	cellColors[cell] = color;
+	setInstanceColor(lattice, cell, color);
+	if (cell % volumeSize == currentLayer) {
+		setInstanceColor(layerCubes, cell / volumeSize, color);
+	}
+	changed = true;
+}
+
+video::SColor VolumeSceneNode::getCubeColor(int cell) const {
+	return cellColors[cell];
+}
+
+void VolumeSceneNode::setRaycubeColor(int entry, video::SColor color) {
+	if (raycubeColors[entry] == color) {
+		return;
+	}
+	raycubeColors[entry] = color;
+	int instance = layerInstance(entry);
+	if (instance >= 0) {
+		setInstanceColor(layerCubes, instance, color);
+	}
+	changed = true;
+}
+
+video::SColor VolumeSceneNode::getRaycubeColor(int entry) const {
+	return raycubeColors[entry];
+}
+
+void VolumeSceneNode::setAtomVisible(int cell, bool visible) {
+	if (atomVisible[cell] != visible) {
+		atomVisible[cell] = visible;
+		atomsDirty = true;
+		changed = true;
+	}
+}
+
+bool VolumeSceneNode::isAtomVisible(int cell) const {
+	return atomVisible[cell];
+}
+
+void VolumeSceneNode::rebuildAtoms() {
+	scene::IVertexBuffer& vertices = atoms->getVertexBuffer();
+	scene::IIndexBuffer& indices = atoms->getIndexBuffer();
+	vertices.set_used(0);
+	indices.set_used(0);
+	for (int cell = 0; cell < volumeSize*volumeSize*volumeSize; ++cell) {
+		if (atomVisible[cell]) {
+			const u32 first = vertices.size();
+			const core::vector3df position = getCellPosition(cell);
+			for (const video::S3DVertex& vertex : atomVertices) {
+				vertices.push_back(vertex);
+				vertices[vertices.size()-1].Pos += position;
+			}
+			for (u32 index : atomIndices) {
+				indices.push_back(first + index);
+			}
+		}
+	}
+	atoms->setDirty(scene::EBT_VERTEX_AND_INDEX);
+	atomsDirty = false;
+}
+
+void VolumeSceneNode::OnRegisterSceneNode() {
+	if (IsVisible) {
+		SceneManager->registerNodeForRendering(this);
+	}
+	ISceneNode::OnRegisterSceneNode();
+}
+
+void VolumeSceneNode::render() {
+	video::IVideoDriver* driver = SceneManager->getVideoDriver();
+	driver->setTransform(video::ETS_WORLD, AbsoluteTransformation);
+	driver->setMaterial(lattice->getMaterial());
+	driver->drawMeshBuffer(lattice);
+	if (atomsDirty) {
+		rebuildAtoms();
+	}
+	if (atoms->getIndexBuffer().size()) {
+		driver->setMaterial(atoms->getMaterial());
+		driver->drawMeshBuffer(atoms);
+	}
+	core::matrix4 layerTransform;
+	layerTransform.setTranslation(core::vector3df(0, layerSpacing()*currentLayer, 0));
+	driver->setTransform(video::ETS_WORLD, AbsoluteTransformation * layerTransform);
+	driver->setMaterial(layerCubes->getMaterial());
+	driver->drawMeshBuffer(layerCubes);
+}
+
+const core::aabbox3d<f32>& VolumeSceneNode::getBoundingBox() const {
+	return box;
+}
+
+u32 VolumeSceneNode::getMaterialCount() const {
+	return 3;
+}
+
+video::SMaterial& VolumeSceneNode::getMaterial(u32 i) {
+	return i == 0 ? layerCubes->getMaterial() : i == 1 ? lattice->getMaterial() : atoms->getMaterial();
+}
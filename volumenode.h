@@ -0,0 +1,110 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BLACKBOX_VOLUMENODE_H
+#define BLACKBOX_VOLUMENODE_H
+
+#include <irrlicht.h>
+#include <vector>
+
+// draws a volume of size*size*size cells (see BasicVolumeRayEngine) as one scene node
+// one layer (a fixed z) is played at a time and looks like the flat board: its cells and the raycubes of
+// the four sides of the layer, with the raycubes of the front and back faces on two panels beside it
+// (a panel cube shoots through the cell at the same place on the board); the other cells are drawn as
+// a lattice of small cubes, so found and missed atoms show through the whole volume after evaluation
+// the layer, the lattice and the atoms are a mesh buffer each, so a frame takes three draw calls for any
+// size, and changing the layer only moves the layer buffer and recolours it
+// the colours are written into the vertices, a 16x16x16 volume changes them once per reset or evaluation
+class VolumeSceneNode : public irr::scene::ISceneNode {
+public:
+	// offset is the position of the lower left corner of the layer
+	VolumeSceneNode(irr::scene::ISceneNode* parent, irr::scene::ISceneManager* mgr, int size, float offset,
+		irr::scene::IMesh* cube, irr::scene::IMesh* atom,
+		irr::video::SColor cubeColor, irr::video::SColor raycubeColor, irr::video::SColor atomColor);
+	virtual ~VolumeSceneNode();
+
+	int size() const {
+		return volumeSize;
+	}
+
+	int layer() const {
+		return currentLayer;
+	}
+
+	// show the layer with the given z
+	void setLayer(int layer);
+
+	// cells and atoms are addressed by their volume cell id, raycubes by their volume entry id
+	void setCubeColor(int cell, irr::video::SColor color);
+	irr::video::SColor getCubeColor(int cell) const;
+	void setRaycubeColor(int entry, irr::video::SColor color);
+	irr::video::SColor getRaycubeColor(int entry) const;
+	void setAtomVisible(int cell, bool visible);
+	bool isAtomVisible(int cell) const;
+
+	// whether a colour, atom or the layer changed since the last call (the volume has to be drawn again)
+	bool takeChanged() {
+		bool was = changed;
+		changed = false;
+		return was;
+	}
+
+	// distance between the layers
+	static float layerSpacing();
+	// distance of the panels of the front and back raycubes from the layer (along Z)
+	static float panelShift(int size);
+
+	virtual void OnRegisterSceneNode();
+	virtual void render();
+	virtual const irr::core::aabbox3d<irr::f32>& getBoundingBox() const;
+	virtual irr::u32 getMaterialCount() const;
+	virtual irr::video::SMaterial& getMaterial(irr::u32 i);
+
+private:
+	// copy the mesh (rotated like the flat board does) scaled to the given position
+	void addInstance(irr::scene::CDynamicMeshBuffer* buffer, irr::scene::IMesh* mesh, const irr::core::vector3df& position, irr::f32 scale, irr::video::SColor color);
+	void setInstanceColor(irr::scene::CDynamicMeshBuffer* buffer, int instance, irr::video::SColor color);
+	// centre of a cell of the layer at z = 0 (cell is x*size+y, just like on the flat board)
+	irr::core::vector3df getLayerPosition(int cell) const;
+	// centre of a volume cell
+	irr::core::vector3df getCellPosition(int cell) const;
+	// instance of a raycube in the layer buffer, -1 if it is not on the current layer
+	int layerInstance(int entry) const;
+	void rebuildAtoms();
+
+	int volumeSize;
+	float volumeOffset;
+	float cubeScale;
+	int currentLayer;
+	// the cells of the current layer, the raycubes of its sides and the two panels
+	irr::scene::CDynamicMeshBuffer* layerCubes;
+	// every cell as a small cube
+	irr::scene::CDynamicMeshBuffer* lattice;
+	irr::scene::CDynamicMeshBuffer* atoms;
+	irr::u32 cubeVertices;
+	// a single atom at the origin
+	std::vector<irr::video::S3DVertex> atomVertices;
+	std::vector<irr::u32> atomIndices;
+	std::vector<bool> atomVisible;
+	bool atomsDirty;
+	std::vector<irr::video::SColor> cellColors;
+	std::vector<irr::video::SColor> raycubeColors;
+	bool changed;
+	irr::core::aabbox3df box;
+};
+
+#endif
@@ -0,0 +1,90 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "workerpool.h"
+#include <algorithm>
+
+WorkerPool::WorkerPool(int threads): generation(0), stopping(false), function(0), context(0), taskCount(0), nextTask(0), busy(0) {
+	if (threads <= 0) {
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	for (int i = 1; i < threads; ++i) {
+		workers.emplace_back(&WorkerPool::work, this);
+	}
+}
+
+WorkerPool::~WorkerPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (auto & worker : workers) {
+		worker.join();
+	}
+}
+
+void WorkerPool::dispatch(int tasks, void (*f)(void*, int), void* c) {
+	if (tasks <= 0) {
+		return;
+	}
+	// a single task is not worth waking anyone
+	if (workers.empty() || tasks == 1) {
+		for (int task = 0; task < tasks; ++task) {
+			f(c, task);
+		}
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		function = f;
+		context = c;
+		taskCount = tasks;
+		nextTask.store(0);
+		busy = static_cast<int>(workers.size());
+		++generation;
+	}
+	wake.notify_all();
+	take();
+	std::unique_lock<std::mutex> lock(mutex);
+	done.wait(lock, [this] { return busy == 0; });
+}
+
+void WorkerPool::work() {
+	std::uint64_t seen = 0;
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [&] { return stopping || generation != seen; });
+			if (stopping) {
+				return;
+			}
+			seen = generation;
+		}
+		take();
+		std::lock_guard<std::mutex> lock(mutex);
+		if (--busy == 0) {
+			done.notify_one();
+		}
+	}
+}
+
+void WorkerPool::take() {
+	for (int task = nextTask.fetch_add(1); task < taskCount; task = nextTask.fetch_add(1)) {
+		function(context, task);
+	}
+}
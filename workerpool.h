@@ -0,0 +1,73 @@
+//  An Irrlicht implementation of the Blackbox board game.
+//
+//  Copyright (C) 2018  Annemarie Mattmann
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BLACKBOX_WORKERPOOL_H
+#define BLACKBOX_WORKERPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// a fixed set of threads for fork-join work of a single caller (e.g. the main loop)
+// run hands the task numbers out to the workers and the calling thread and returns once all tasks
+// are done; the threads are started once and a run neither starts threads nor allocates
+class WorkerPool {
+public:
+	// threads = 0 uses all cores, the calling thread counts as one of them
+	explicit WorkerPool(int threads = 0);
+	~WorkerPool();
+
+	int threads() const {
+		return static_cast<int>(workers.size()) + 1;
+	}
+
+	// call f(task) for every task in 0..tasks-1, in any order and on any thread
+	template <class F>
+	void run(int tasks, F& f) {
+		dispatch(tasks, &call<F>, &f);
+	}
+
+private:
+	template <class F>
+	static void call(void* f, int task) {
+		(*static_cast<F*>(f))(task);
+	}
+
+	void dispatch(int tasks, void (*function)(void*, int), void* context);
+	void work();
+	// run tasks until there are none left
+	void take();
+
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable done;
+	// counts the runs, a worker joins every run once
+	std::uint64_t generation;
+	bool stopping;
+	// the current run
+	void (*function)(void*, int);
+	void* context;
+	int taskCount;
+	std::atomic<int> nextTask;
+	int busy;
+};
+
+#endif